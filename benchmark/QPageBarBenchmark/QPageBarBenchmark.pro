@@ -0,0 +1,33 @@
+QT       += core gui testlib
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+# Run without a display server, e.g. on CI:
+#   ./QPageBarBenchmark -o results.csv,csv
+# Use -o results.xml,xml for XML, or -callgrind/-tickcounter for other measurements
+
+SOURCES += \
+    qpagebarbenchmark.cpp \
+    ../../src/english/qpagebar.cpp \
+    ../../src/english/qpagebarmodel.cpp \
+    ../../src/english/qpagebarpainter.cpp \
+    ../../src/english/qpagekeyindex.cpp \
+    ../../src/english/qpagelatency.cpp \
+    ../../src/english/qpagenumbervalidator.cpp \
+    ../../src/english/qpagetrace.cpp \
+    ../../src/english/qpaintedpagebar.cpp
+
+HEADERS += \
+    ../../src/english/pagewindow.h \
+    ../../src/english/qpagebar.h \
+    ../../src/english/qpagebarmodel.h \
+    ../../src/english/qpagebarpainter.h \
+    ../../src/english/qpagekeyindex.h \
+    ../../src/english/qpagelatency.h \
+    ../../src/english/qpagenumbervalidator.h \
+    ../../src/english/qpageprovider.h \
+    ../../src/english/qpagetrace.h \
+    ../../src/english/qpaintedpagebar.h
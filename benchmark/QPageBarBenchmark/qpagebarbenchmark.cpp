@@ -0,0 +1,292 @@
+#include <QApplication>
+#include <QImage>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QSignalSpy>
+#include <QtTest>
+#include <cstdlib>
+
+#include "../../src/english/qpagebar.h"
+#include "../../src/english/qpaintedpagebar.h"
+
+// mallinfo2 reports the heap in use, it needs glibc 2.33 or later
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define QPAGEBAR_BENCHMARK_HEAP
+#endif
+
+/**
+* @brief Benchmarks of the hot paths of QPageBar. Run with -o results.csv,csv or -o results.xml,xml for machine-readable results
+*/
+class QPageBarBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void setCount_data();
+    void setCount();
+    void setCountNewBar_data();
+    void setCountNewBar();
+    void clickNext_data();
+    void clickNext();
+    void jump_data();
+    void jump();
+    void clickToPageChanged_data();
+    void clickToPageChanged();
+    void objectCount_data();
+    void objectCount();
+    void heapBytes_data();
+    void heapBytes();
+    void paint_data();
+    void paint();
+
+private:
+    /**
+    * @brief Rows with the show counts from 5 to 500
+    */
+    static void addShowCounts();
+
+    /**
+    * @brief Rows with the show counts for both the button bar and the painted bar
+    */
+    static void addWidgetsAndShowCounts();
+
+    static QWidget* createBar(const QString& widget, int showCount);
+    static QPushButton* findButton(QWidget* bar, const QString& text);
+    static QVector<QPushButton*> pageButtons(QWidget* bar);
+};
+
+// Far more pages than any benchmark can click through, so the > button never reaches the last page
+static const qint64 kTotalCount = Q_INT64_C(1000000000000);
+
+void QPageBarBenchmark::initTestCase()
+{
+    // The first widget loads fonts and the style, which should not be counted in the first row
+    delete createBar(QStringLiteral("QPageBar"), 5);
+    delete createBar(QStringLiteral("QPaintedPageBar"), 5);
+}
+
+void QPageBarBenchmark::addShowCounts()
+{
+    QTest::addColumn<int>("showCount");
+    for (int showCount : { 5, 10, 50, 100, 500 })
+        QTest::newRow(qPrintable(QStringLiteral("show %1").arg(showCount))) << showCount;
+}
+
+void QPageBarBenchmark::addWidgetsAndShowCounts()
+{
+    QTest::addColumn<QString>("widget");
+    QTest::addColumn<int>("showCount");
+    for (const QString& widget : { QStringLiteral("QPageBar"), QStringLiteral("QPaintedPageBar") })
+    {
+        for (int showCount : { 5, 10, 50, 100, 500 })
+            QTest::newRow(qPrintable(QStringLiteral("%1 show %2").arg(widget).arg(showCount))) << widget << showCount;
+    }
+}
+
+QWidget* QPageBarBenchmark::createBar(const QString& widget, int showCount)
+{
+    if (widget == QLatin1String("QPaintedPageBar"))
+        return new QPaintedPageBar(kTotalCount, showCount);
+    return new QPageBar(kTotalCount, showCount);
+}
+
+QPushButton* QPageBarBenchmark::findButton(QWidget* bar, const QString& text)
+{
+    for (QPushButton* button : bar->findChildren<QPushButton*>())
+    {
+        if (button->text() == text)
+            return button;
+    }
+    return nullptr;
+}
+
+QVector<QPushButton*> QPageBarBenchmark::pageButtons(QWidget* bar)
+{
+    // The page buttons are the only checkable buttons, in the order of the pool
+    QVector<QPushButton*> buttons;
+    for (QPushButton* button : bar->findChildren<QPushButton*>())
+    {
+        if (button->isCheckable() && button->isVisibleTo(bar))
+            buttons.append(button);
+    }
+    return buttons;
+}
+
+void QPageBarBenchmark::setCount_data()
+{
+    addShowCounts();
+}
+
+void QPageBarBenchmark::setCount()
+{
+    // setCount on a bar that already has its buttons, e.g. after every query
+    QFETCH(int, showCount);
+    QPageBar bar(kTotalCount, showCount);
+    QBENCHMARK
+    {
+        bar.setCount(kTotalCount, showCount);
+    }
+}
+
+void QPageBarBenchmark::setCountNewBar_data()
+{
+    addShowCounts();
+}
+
+void QPageBarBenchmark::setCountNewBar()
+{
+    // The first setCount creates all page buttons
+    QFETCH(int, showCount);
+    QBENCHMARK
+    {
+        QPageBar bar;
+        bar.setCount(kTotalCount, showCount);
+    }
+}
+
+void QPageBarBenchmark::clickNext_data()
+{
+    QTest::addColumn<int>("showCount");
+    QTest::addColumn<bool>("elided");
+    for (int showCount : { 5, 10, 50, 100, 500 })
+    {
+        QTest::newRow(qPrintable(QStringLiteral("show %1").arg(showCount))) << showCount << false;
+        QTest::newRow(qPrintable(QStringLiteral("show %1 elided").arg(showCount))) << showCount << true;
+    }
+}
+
+void QPageBarBenchmark::clickNext()
+{
+    // Starting on the last visible page, every > click shifts the window and relabels the page buttons
+    QFETCH(int, showCount);
+    QFETCH(bool, elided);
+    QPageBar bar(kTotalCount, showCount);
+    bar.setElided(elided);
+    bar.setCurrentPage(showCount);
+    QPushButton* nextButton = findButton(&bar, QStringLiteral(">"));
+    QVERIFY(nextButton != nullptr);
+
+    QBENCHMARK
+    {
+        nextButton->click();
+    }
+}
+
+void QPageBarBenchmark::jump_data()
+{
+    addShowCounts();
+}
+
+void QPageBarBenchmark::jump()
+{
+    // Jumping back and forth between two distant pages moves the whole window every time
+    QFETCH(int, showCount);
+    QPageBar bar(kTotalCount, showCount);
+    QLineEdit* lineEdit = bar.findChild<QLineEdit*>();
+    QPushButton* jumpButton = findButton(&bar, QStringLiteral("Ok"));
+    QVERIFY(lineEdit != nullptr && jumpButton != nullptr);
+    const QString farPage = QString::number(kTotalCount / 2);
+    const QString nearPage = QString::number(showCount * 2);
+
+    QBENCHMARK
+    {
+        lineEdit->setText(farPage);
+        jumpButton->click();
+        lineEdit->setText(nearPage);
+        jumpButton->click();
+    }
+}
+
+void QPageBarBenchmark::clickToPageChanged_data()
+{
+    addShowCounts();
+}
+
+void QPageBarBenchmark::clickToPageChanged()
+{
+    // A real mouse click on a shown bar, from the press event to the delivery of pageChanged
+    QFETCH(int, showCount);
+    QPageBar bar(kTotalCount, showCount);
+    bar.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&bar));
+    QVector<QPushButton*> buttons = pageButtons(&bar);
+    QVERIFY(buttons.size() >= 2);
+    QSignalSpy spy(&bar, &QPageBar::pageChanged);
+
+    QBENCHMARK
+    {
+        QTest::mouseClick(buttons[1], Qt::LeftButton);
+        QTest::mouseClick(buttons[0], Qt::LeftButton);
+    }
+    QVERIFY(spy.count() > 0);
+}
+
+void QPageBarBenchmark::objectCount_data()
+{
+    addWidgetsAndShowCounts();
+}
+
+void QPageBarBenchmark::objectCount()
+{
+    // The bar itself and all of its children, including layouts and timers
+    QFETCH(QString, widget);
+    QFETCH(int, showCount);
+    QScopedPointer<QWidget> bar(createBar(widget, showCount));
+    QTest::setBenchmarkResult(1 + bar->findChildren<QObject*>().size(), QTest::Events);
+}
+
+void QPageBarBenchmark::heapBytes_data()
+{
+    addWidgetsAndShowCounts();
+}
+
+void QPageBarBenchmark::heapBytes()
+{
+#ifdef QPAGEBAR_BENCHMARK_HEAP
+    QFETCH(QString, widget);
+    QFETCH(int, showCount);
+    qint64 before = qint64(mallinfo2().uordblks);
+    QScopedPointer<QWidget> bar(createBar(widget, showCount));
+    qint64 after = qint64(mallinfo2().uordblks);
+    QTest::setBenchmarkResult(qreal(after - before), QTest::BytesAllocated);
+#else
+    QSKIP("Measuring the heap needs glibc 2.33 or later");
+#endif
+}
+
+void QPageBarBenchmark::paint_data()
+{
+    addWidgetsAndShowCounts();
+}
+
+void QPageBarBenchmark::paint()
+{
+    // A full repaint of the bar and all of its children into an image, at the size the bar asks for
+    QFETCH(QString, widget);
+    QFETCH(int, showCount);
+    QScopedPointer<QWidget> bar(createBar(widget, showCount));
+    bar->resize(bar->sizeHint());
+    QImage image(bar->size(), QImage::Format_ARGB32_Premultiplied);
+    QVERIFY(!image.isNull());
+
+    QBENCHMARK
+    {
+        bar->render(&image);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // Run without a display server unless another platform is chosen
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QPageBarBenchmark benchmark;
+    return QTest::qExec(&benchmark, argc, argv);
+}
+
+#include "qpagebarbenchmark.moc"
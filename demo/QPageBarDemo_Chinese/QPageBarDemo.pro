@@ -11,10 +11,22 @@ CONFIG += c++17
 SOURCES += \
     main.cpp \
     ../../src/chinese/qpagebar.cpp \
+    ../../src/chinese/qpagebarmodel.cpp \
+    ../../src/chinese/qpagekeyindex.cpp \
+    ../../src/chinese/qpagelatency.cpp \
+    ../../src/chinese/qpagenumbervalidator.cpp \
+    ../../src/chinese/qpagetrace.cpp \
     widget.cpp
 
 HEADERS += \
+    ../../src/chinese/pagewindow.h \
     ../../src/chinese/qpagebar.h \
+    ../../src/chinese/qpagebarmodel.h \
+    ../../src/chinese/qpagekeyindex.h \
+    ../../src/chinese/qpagelatency.h \
+    ../../src/chinese/qpagenumbervalidator.h \
+    ../../src/chinese/qpageprovider.h \
+    ../../src/chinese/qpagetrace.h \
     widget.h
 
 FORMS += \
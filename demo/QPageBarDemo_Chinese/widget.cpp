@@ -9,8 +9,8 @@ Widget::Widget(QWidget *parent)
 {
     ui->setupUi(this);
     ui->pageBar->setCount(5, 3);
-    connect(ui->pageBar, &QPageBar::pageChanged, this, [&](int idx) {
-        ui->stackedWidget->setCurrentIndex(idx - 1);
+    connect(ui->pageBar, &QPageBar::pageChanged, this, [&](qint64 idx) {
+        ui->stackedWidget->setCurrentIndex(int(idx - 1));
     });
 }
 
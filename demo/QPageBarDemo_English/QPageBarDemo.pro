@@ -11,10 +11,22 @@ CONFIG += c++17
 SOURCES += \
     main.cpp \
     ../../src/english/qpagebar.cpp \
+    ../../src/english/qpagebarmodel.cpp \
+    ../../src/english/qpagekeyindex.cpp \
+    ../../src/english/qpagelatency.cpp \
+    ../../src/english/qpagenumbervalidator.cpp \
+    ../../src/english/qpagetrace.cpp \
     widget.cpp
 
 HEADERS += \
+    ../../src/english/pagewindow.h \
     ../../src/english/qpagebar.h \
+    ../../src/english/qpagebarmodel.h \
+    ../../src/english/qpagekeyindex.h \
+    ../../src/english/qpagelatency.h \
+    ../../src/english/qpagenumbervalidator.h \
+    ../../src/english/qpageprovider.h \
+    ../../src/english/qpagetrace.h \
     widget.h
 
 FORMS += \
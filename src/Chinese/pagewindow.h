@@ -0,0 +1,357 @@
+﻿#ifndef PAGEWINDOW_H
+#define PAGEWINDOW_H
+
+#include <QtGlobal>
+
+/**
+* @brief QPageBar背后的分页状态：页面总数、页码按钮显示的窗口以及当前页
+*        只用到了QtCore中的qint64，也不分配内存，所以没有QApplication也能使用（和测试）
+*        所有操作都是O(1)的，页码从1开始，是64位的，页码按钮的数量是int
+*/
+class PageWindow
+{
+public:
+    constexpr PageWindow() noexcept = default;
+
+    /**
+    * @brief 构造函数
+    * @param totalCount 全部的页面数量
+    * @param showCount 显示的页码按钮数量
+    */
+    constexpr PageWindow(qint64 totalCount, int showCount) noexcept
+    {
+        setCount(totalCount, showCount);
+    }
+
+    /**
+    * @brief 设置页面的数量并回到第1页，showCount不会超过totalCount，
+    *        所以setCount(0, showCount)得到一个空窗口，setTotalCount会让它最多增长到showCount个按钮
+    * @param totalCount 全部的页面数量
+    * @param showCount 显示的页码按钮数量
+    */
+    constexpr void setCount(qint64 totalCount, int showCount) noexcept
+    {
+        if (showCount > 0)
+            m_maxShowCount = showCount;
+        if (totalCount <= 0 || showCount <= 0)
+        {
+            clear();
+            return;
+        }
+        m_totalCount = totalCount;
+        m_showCount = showCount < totalCount ? showCount : int(totalCount);
+        m_currentPage = 1;
+        m_start = m_elided ? elidedStart() : 1;
+    }
+
+    /**
+    * @brief 修改页面的数量，保留当前页和窗口。只有页面总数缩小到它们之下时才会被限制，
+    *        showCount随页面总数缩小，最多恢复到setCount时的showCount
+    * @param totalCount 全部的页面数量，0表示没有页面
+    * @return 当前页改变了返回true
+    */
+    constexpr bool setTotalCount(qint64 totalCount) noexcept
+    {
+        qint64 oldPage = m_currentPage;
+        m_totalCount = totalCount > 0 ? totalCount : 0;
+        m_showCount = m_maxShowCount < m_totalCount ? m_maxShowCount : int(m_totalCount);
+        if (isEmpty())
+        {
+            m_start = 1;
+            m_currentPage = 1;
+        }
+        else
+        {
+            restore(m_start, m_currentPage);
+        }
+        return m_currentPage != oldPage;
+    }
+
+    /**
+    * @brief 修改页码按钮的数量，保留当前页，并且当前页仍然可见。showCount会被限制在totalCount之内
+    * @param showCount 显示的页码按钮数
+    */
+    constexpr void setShowCount(int showCount) noexcept
+    {
+        if (showCount <= 0)
+            return;
+        m_maxShowCount = showCount;
+        m_showCount = showCount < m_totalCount ? showCount : int(m_totalCount);
+        restore(m_start, m_currentPage);
+    }
+
+    /**
+    * @brief 在连续布局和省略布局之间切换。连续布局中页码按钮显示showCount个连续的页码，
+    *        省略布局"1 … 498 499 [500] 501 502 … 1000000"中显示当前页周围的showCount页以及第一页和最后一页
+    *        无论页面总数多大，省略布局最多使用showCount + 4个格子
+    * @param elided 是否使用省略布局
+    */
+    constexpr void setElided(bool elided) noexcept
+    {
+        m_elided = elided;
+        if (m_elided)
+            m_start = elidedStart();
+        else
+            restore(m_start, m_currentPage);
+    }
+
+    constexpr bool isElided() const noexcept { return m_elided; }
+
+    /**
+    * @brief 把页面总数标记为不确定的，即它只是真实页面数量的估计值或者下限。
+    *        此时最后一页上>按钮仍然可用，next()会给页面总数加上一页
+    * @param openEnded 是否可能存在比totalCount更多的页面
+    */
+    constexpr void setOpenEnded(bool openEnded) noexcept { m_openEnded = openEnded; }
+    constexpr bool isOpenEnded() const noexcept { return m_openEnded; }
+
+    /**
+    * @brief 清空为没有页面的状态，布局和setCount时的showCount保持不变
+    */
+    constexpr void clear() noexcept
+    {
+        m_totalCount = 0;
+        m_showCount = 0;
+        m_start = 1;
+        m_currentPage = 1;
+    }
+
+    /**
+    * @brief 切换到指定的页面，窗口尽可能少地移动，使这一页能显示出来
+    * @param page 页号，范围1~totalCount
+    * @return 当前页改变了则返回true
+    */
+    constexpr bool setCurrentPage(qint64 page) noexcept
+    {
+        if (!contains(page) || page == m_currentPage)
+            return false;
+
+        // 省略布局中窗口以当前页为中心
+        if (m_elided)
+        {
+            m_currentPage = page;
+            m_start = elidedStart();
+            return true;
+        }
+
+        // 如果要跳转的页面比显示的最小页码要小，就作为第一个按钮
+        if (page < m_start)
+            m_start = page;
+        // 如果要跳转的页面比显示的最大页码要大，就作为最后一个按钮
+        else if (page > end())
+            m_start = page - m_showCount + 1;
+        m_currentPage = page;
+        return true;
+    }
+
+    /**
+    * @brief 恢复之前通过start()和currentPage()保存的窗口，两者都会被限制在有效范围内，保证当前页一定可见
+    * @param start 显示的最左面的页码
+    * @param currentPage 当前选中的页码
+    */
+    constexpr void restore(qint64 start, qint64 currentPage) noexcept
+    {
+        if (isEmpty())
+            return;
+
+        m_currentPage = currentPage < 1 ? 1 : (currentPage > m_totalCount ? m_totalCount : currentPage);
+        if (m_elided)
+        {
+            m_start = elidedStart();
+            return;
+        }
+        qint64 minStart = m_currentPage - m_showCount + 1 < 1 ? 1 : m_currentPage - m_showCount + 1;
+        qint64 maxStart = m_currentPage < m_totalCount - m_showCount + 1 ? m_currentPage : m_totalCount - m_showCount + 1;
+        m_start = start < minStart ? minStart : (start > maxStart ? maxStart : start);
+    }
+
+    /**
+    * @brief 切换到上一页（< 按钮）
+    * @return 当前页改变了则返回true
+    */
+    constexpr bool previous() noexcept
+    {
+        return setCurrentPage(m_currentPage - 1);
+    }
+
+    /**
+    * @brief 切换到下一页（> 按钮）
+    * @return 当前页改变了则返回true
+    */
+    constexpr bool next() noexcept
+    {
+        // 总数不确定时，认为最后一页之后还有下一页
+        if (m_openEnded && !isEmpty() && m_currentPage == m_totalCount)
+            setTotalCount(m_totalCount + 1);
+        return setCurrentPage(m_currentPage + 1);
+    }
+
+    constexpr qint64 totalCount() const noexcept { return m_totalCount; }
+    constexpr int showCount() const noexcept { return m_showCount; }
+    constexpr qint64 currentPage() const noexcept { return m_currentPage; }
+
+    /**
+    * @brief setCount或setShowCount时的showCount，页面总数增加时showCount最多恢复到它
+    */
+    constexpr int maxShowCount() const noexcept { return m_maxShowCount; }
+
+    /**
+    * @brief 显示的页面中最左面的（也就是最小的）页码，省略布局中是当前页周围的页面中的
+    */
+    constexpr qint64 start() const noexcept { return m_start; }
+
+    /**
+    * @brief 显示的页面中最右面的（也就是最大的）页码，省略布局中是当前页周围的页面中的
+    */
+    constexpr qint64 end() const noexcept { return m_start + m_showCount - 1; }
+
+    constexpr bool isEmpty() const noexcept { return m_totalCount == 0; }
+
+    /**
+    * @brief page是否是有效的页码
+    */
+    constexpr bool contains(qint64 page) const noexcept { return page >= 1 && page <= m_totalCount; }
+
+    /**
+    * @brief page是否显示在某个页码按钮上
+    */
+    constexpr bool isVisible(qint64 page) const noexcept { return !isEmpty() && page >= m_start && page <= end(); }
+
+    /**
+    * @brief 第index个页码按钮（0 ~ showCount - 1）显示的页码
+    */
+    constexpr qint64 pageAt(int index) const noexcept { return m_start + index; }
+
+    /**
+    * @brief 显示page的页码按钮的下标，没有显示则返回-1
+    */
+    constexpr int indexOf(qint64 page) const noexcept { return isVisible(page) ? int(page - m_start) : -1; }
+
+    /**
+    * @brief 第index个页码按钮是否是选中的那个
+    */
+    constexpr bool isCurrent(int index) const noexcept { return pageAt(index) == m_currentPage; }
+
+    /**
+    * @brief 省略布局是否真的省略了页面，即showCount + 4个格子放不下所有页面
+    */
+    constexpr bool hasEllipses() const noexcept { return m_elided && m_totalCount > m_showCount + 4; }
+
+    /**
+    * @brief 布局需要的格子（页码按钮和省略号）数量，连续布局中和showCount相同
+    */
+    constexpr int cellCount() const noexcept
+    {
+        if (!m_elided)
+            return m_showCount;
+        return hasEllipses() ? m_showCount + 4 : int(m_totalCount);
+    }
+
+    /**
+    * @brief 第index个格子（0 ~ cellCount - 1）显示的页码
+    * @return 页码，格子是省略号时返回0
+    */
+    constexpr qint64 cellPage(int index) const noexcept
+    {
+        if (!m_elided)
+            return pageAt(index);
+        if (!hasEllipses())
+            return index + 1;
+
+        // 格子依次是：1、2或…、当前页周围的页面、totalCount - 1或…、totalCount
+        if (index == 0)
+            return 1;
+        if (index == cellCount() - 1)
+            return m_totalCount;
+        if (index == 1)
+            return m_start == 3 ? 2 : 0;
+        if (index == cellCount() - 2)
+            return end() == m_totalCount - 2 ? m_totalCount - 1 : 0;
+        return m_start + index - 2;
+    }
+
+    /**
+    * @brief 显示page的格子的下标，没有显示则返回-1
+    */
+    constexpr int cellOf(qint64 page) const noexcept
+    {
+        if (!m_elided)
+            return indexOf(page);
+        if (!contains(page))
+            return -1;
+        if (!hasEllipses())
+            return int(page - 1);
+
+        if (page == 1)
+            return 0;
+        if (page == m_totalCount)
+            return cellCount() - 1;
+        if (page >= m_start && page <= end())
+            return int(page - m_start) + 2;
+        if (page == 2 && m_start == 3)
+            return 1;
+        if (page == m_totalCount - 1 && end() == m_totalCount - 2)
+            return cellCount() - 2;
+        return -1;
+    }
+
+    /**
+    * @brief < 按钮是否可用
+    */
+    constexpr bool canGoPrevious() const noexcept { return !isEmpty() && m_currentPage > 1; }
+
+    /**
+    * @brief > 按钮是否可用
+    */
+    constexpr bool canGoNext() const noexcept { return m_currentPage < m_totalCount || (m_openEnded && !isEmpty()); }
+
+private:
+    /**
+    * @brief 省略布局的起始页码：当前页居中，但窗口要留在前两个格子和后两个格子之间
+    */
+    constexpr qint64 elidedStart() const noexcept
+    {
+        if (!hasEllipses())
+            return 1;
+        qint64 start = m_currentPage - m_showCount / 2;
+        qint64 maxStart = m_totalCount - m_showCount - 1;
+        return start < 3 ? 3 : (start > maxStart ? maxStart : start);
+    }
+
+    /**
+    * @brief 页面总数
+    */
+    qint64 m_totalCount = 0;
+
+    /**
+    * @brief 在pageBar中显示的页面数
+    */
+    int m_showCount = 0;
+
+    /**
+    * @brief setCount时的showCount，页面总数增加时m_showCount最多恢复到它
+    */
+    int m_maxShowCount = 0;
+
+    /**
+    * @brief 显示的页面中最左面的（也就是最小的）页码
+    */
+    qint64 m_start = 1;
+
+    /**
+    * @brief 当前选中的页码
+    */
+    qint64 m_currentPage = 1;
+
+    /**
+    * @brief 是否使用省略布局
+    */
+    bool m_elided = false;
+
+    /**
+    * @brief m_totalCount是否只是估计值或者下限
+    */
+    bool m_openEnded = false;
+};
+
+#endif // !PAGEWINDOW_H
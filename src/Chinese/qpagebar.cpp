@@ -2,17 +2,43 @@
 
 #include <QLabel>
 #include <QPushButton>
+#include <QComboBox>
 #include <QHBoxLayout>
-#include <QMessageBox>
+#include <QToolTip>
+#include <QStyleOptionButton>
+#include <QStyle>
+#include <QLocale>
+#include <QKeyEvent>
 #include <QDebug>
 
+// 拖动滑块最多的步数，更多的页面会按比例缩放到这些步数
+static const int ScrubSteps = 100000;
+
 QPageBar::QPageBar(QWidget* parent) :
     QWidget(parent),
-    m_pageTotalCount(0),
-    m_pageShowCount(0),
     m_countLabel(new QLabel(tr(u8"共") + QString::number(0) + tr(u8"页"), this)),
     m_pageLineEdit(new QLineEdit(this)),
-    m_jumpButton(new QPushButton(tr(u8"确定"), this))
+    m_jumpButton(new QPushButton(tr(u8"确定"), this)),
+    m_pageSizeBox(nullptr),
+    m_scrubSlider(nullptr),
+    m_previewPage(0),
+    m_estimatedCount(0),
+    m_keysetMode(false),
+    m_keyIndex(nullptr),
+    m_updateDepth(0),
+    m_latencyTracker(nullptr),
+    m_model(nullptr),
+    m_autoShowCount(false),
+    m_fittedShowCount(0),
+    m_manualShowCount(0),
+    m_cellWidth(0),
+    m_cellDigits(0),
+    m_postedTotalCount(-1),
+    m_postedPage(0),
+    m_applyQueued(false),
+    m_snapshotSequence(0),
+    m_snapshotPage(1),
+    m_snapshotCount(0)
 {
     // 1. 初始化layout以及各种控件，如果需要调整控件大小或字体，就在这部分代码里面修改
     // 1.1 设置横向布局
@@ -21,28 +47,27 @@ QPageBar::QPageBar(QWidget* parent) :
 
     // 1.2 初始化上一页按钮
     m_previousButton = new QPushButton(tr("<"), this);
-    m_previousButton->setWhatsThis("-1");  // 通过WhatsThis来记录当前按钮属于哪个按钮，方便按钮点击后逻辑的处理
     m_previousButton->setEnabled(false);
 
     // 1.3 初始化下一页按钮
     m_nextButton = new QPushButton(">");
-    m_nextButton->setWhatsThis("-2");    // 通过WhatsThis来记录当前按钮属于哪个按钮，方便按钮点击后逻辑的处理
     QLabel* label1 = new QLabel(tr(u8"前往"), this);
     QLabel* label2 = new QLabel(tr(u8"页"), this);
 
-    // 1.4 设置页码输入框的大小
+    // 1.4 设置页码输入框的大小，它只接受存在的页码
     m_pageLineEdit->setMaximumWidth(75);
+    m_pageValidator = new QPageNumberValidator(this);
+    m_pageLineEdit->setValidator(m_pageValidator);
 
-    // 1.5 设置字体
-    QFont font;
-    font.setPointSize(10);
-    m_countLabel->setFont(font);
-    m_pageLineEdit->setFont(font);
-    label1->setFont(font);
-    label2->setFont(font);
-    m_previousButton->setFont(font);
-    m_nextButton->setFont(font);
-    m_jumpButton->setFont(font);
+    // 1.5 设置字体，所有按钮共用这个字体
+    m_font.setPointSize(10);
+    m_countLabel->setFont(m_font);
+    m_pageLineEdit->setFont(m_font);
+    label1->setFont(m_font);
+    label2->setFont(m_font);
+    m_previousButton->setFont(m_font);
+    m_nextButton->setFont(m_font);
+    m_jumpButton->setFont(m_font);
 
 
     // 2. 把控件加入layout中
@@ -63,95 +88,291 @@ QPageBar::QPageBar(QWidget* parent) :
     connect(m_nextButton, &QPushButton::clicked, this, &QPageBar::onButtonClicked);
     // 3.3 跳转按钮的逻辑
     connect(m_jumpButton, &QPushButton::clicked, this, [&]() {
-        bool isOk;
-        int page = m_pageLineEdit->text().toInt(&isOk);
-        if (!isOk || page < 1 || page > m_pageTotalCount)
+        // 设置了键索引时，输入的是键，比如客户ID或者时间戳
+        if (m_keyIndex != nullptr)
         {
-            QMessageBox errMsgBox(QMessageBox::Critical, tr(u8"页码错误"),
-                                  tr(u8"请输入正确的页码，范围1~%1").arg(m_pageTotalCount));
-            errMsgBox.exec();
+            if (jumpToKey(m_pageLineEdit->text()) == 0)
+                setInputError(tr(u8"找不到%1所在的页面").arg(m_pageLineEdit->text()));
+            return;
         }
+
+        bool isOk;
+        qint64 page = m_pageLineEdit->text().toLongLong(&isOk);
+        if (!isOk || !m_window.contains(page))
+            setInputError(tr(u8"请输入正确的页码，范围1~%1").arg(m_window.totalCount()));
+        else if (!isPageReachable(page))
+            setInputError(tr(u8"只能打开访问过的页面以及它们相邻的页面"));
         else
         {
-            if (m_currentPage == page)
-                return;
-
-            // 如果要跳转的页面当前已经显示，则直接切换
-            if (m_pageStart <= page && m_pageStart + m_pageShowCount - 1 >= page)
-            {
-                m_pageButtons[m_currentPage - m_pageStart]->setChecked(false);
-                m_pageButtons[page - m_pageStart]->setChecked(true);
-            }
-            // 如果没有显示，情况1：要跳转的页面比显示的最小页码要小
-            else if (m_pageStart > page)
-            {
-                for (int i = 0; i < m_pageShowCount; i++)
-                {
-                    m_pageButtons[i]->setWhatsThis(QString::number(page + i));
-                    m_pageButtons[i]->setText(QString::number(page + i));
-                    m_pageButtons[i]->setChecked(false);
-                }
-                m_pageButtons[0]->setChecked(true);
-                m_pageStart = page;
-            }
-            // 情况2：要跳转的页面比显示的最大页码要大
-            else
-            {
-                for (int i = 0; i < m_pageShowCount; i++)
-                {
-                    m_pageButtons[i]->setWhatsThis(QString::number(page - m_pageShowCount + i + 1));
-                    m_pageButtons[i]->setText(QString::number(page - m_pageShowCount + i + 1));
-                    m_pageButtons[i]->setChecked(false);
-                }
-                m_pageButtons[m_pageShowCount - 1]->setChecked(true);
-                m_pageStart = page - m_pageShowCount + 1;
-            }
-            m_currentPage = page;
-            emit pageChanged(page);
+            if (!m_trace.isNull())
+                m_trace->record(QPageTrace::Jump, page);
+            setInputError(QString());
+            moveToPage(page);
         }
     });
+    // 3.4 在页码输入框中按回车和点击跳转按钮一样，见eventFilter，输入时清除错误
+    m_pageLineEdit->installEventFilter(this);
+    connect(m_pageLineEdit, &QLineEdit::textEdited, this, [&]() { setInputError(QString()); });
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    // 超出范围的按键会被validator拒绝，错误信息说明原因
+    connect(m_pageLineEdit, &QLineEdit::inputRejected, this, [&]() {
+        if (m_keyIndex == nullptr)
+            setInputError(tr(u8"请输入正确的页码，范围1~%1").arg(m_window.totalCount()));
+    });
+#endif
+
+    // 4. 用于合并pageChanged的定时器，见setCoalescing
+    m_committedPage = 1;
+    m_quietTimer = new QTimer(this);
+    m_quietTimer->setSingleShot(true);
+    m_maxDelayTimer = new QTimer(this);
+    m_maxDelayTimer->setSingleShot(true);
+    connect(m_quietTimer, &QTimer::timeout, this, &QPageBar::commitPage);
+    connect(m_maxDelayTimer, &QTimer::timeout, this, &QPageBar::commitPage);
+
+    // 5. 从provider加载页面，见setPageProvider
+    m_pageProvider = nullptr;
+    m_loadingPage = 0;
+    m_pageSize = 0;
+    m_rowCount = -1;
+    m_pageWatcher = new QFutureWatcher<QVariant>(this);
+    connect(m_pageWatcher, &QFutureWatcher<QVariant>::finished, this, &QPageBar::onPageLoaded);
 }
 
-QPageBar::QPageBar(int pageTotalCount, int pageShowCount, QWidget* parent) : QPageBar(parent)
+QPageBar::QPageBar(qint64 pageTotalCount, int pageShowCount, QWidget* parent) : QPageBar(parent)
 {
     setCount(pageTotalCount, pageShowCount);
     if (pageTotalCount > 0)
         m_pageButtons[0]->setChecked(true);
 }
 
-void QPageBar::setCount(int totalCount, int showCount)
+void QPageBar::setCount(qint64 totalCount, int showCount)
+{
+    if (showCount <= 0)
+    {
+        qDebug() << "showCount必须大于0";
+        return;
+    }
+
+    if (!m_trace.isNull())
+        m_trace->record(QPageTrace::Count, totalCount, showCount);
+    m_window.setOpenEnded(false);
+    m_rowCount = -1;
+    resetCount(totalCount, showCount);
+}
+
+void QPageBar::setRowCount(qint64 rowCount, int showCount)
+{
+    if (m_pageSize <= 0)
+    {
+        qDebug() << "setRowCount之前必须设置pageSize"; // the page size must be set before setRowCount
+        return;
+    }
+
+    // The last page may be partial, fewer pages than page buttons are fine here
+    qint64 totalCount = (qMax<qint64>(rowCount, 0) + m_pageSize - 1) / m_pageSize;
+    if (!m_trace.isNull())
+        m_trace->record(QPageTrace::RowCount, rowCount, showCount);
+    m_window.setOpenEnded(false);
+    m_rowCount = qMax<qint64>(rowCount, 0);
+    resetCount(totalCount, showCount);
+}
+
+qint64 QPageBar::rowCount()
+{
+    return m_rowCount;
+}
+
+void QPageBar::setEstimatedCount(qint64 estimate, int showCount)
+{
+    // 没有估计值时只知道第1页存在
+    if (!m_trace.isNull())
+        m_trace->record(QPageTrace::EstimatedCount, estimate, showCount);
+    m_estimatedCount = estimate > 0 ? estimate : 0;
+    m_window.setOpenEnded(true);
+    m_rowCount = -1;
+    resetCount(qMax<qint64>(m_estimatedCount, 1), showCount);
+}
+
+void QPageBar::resetCount(qint64 totalCount, int showCount)
+{
+    // 1. 初始化分页状态，丢弃还没激活的pageChanged
+    m_window.setCount(totalCount, showCount);
+    if (m_autoShowCount)
+    {
+        m_manualShowCount = m_window.maxShowCount();
+        m_fittedShowCount = 0;
+        fitShowCount();
+    }
+    m_pageKeys.clear();
+    m_quietTimer->stop();
+    m_maxDelayTimer->stop();
+    m_committedPage = m_window.currentPage();
+
+    updateCountLabel();
+
+    // 2. 复用已有的页码按钮，只创建或隐藏相差的部分
+    resizeButtonPool(m_window.cellCount());
+    updateButtons();
+    publishState();
+}
+
+void QPageBar::setTotalCount(qint64 totalCount)
+{
+    if (!m_trace.isNull())
+        m_trace->record(QPageTrace::TotalCount, totalCount);
+    m_window.setOpenEnded(false);
+    m_rowCount = -1;
+    updateTotalCount(totalCount);
+}
+
+void QPageBar::setEstimate(qint64 estimate)
+{
+    if (!m_window.isOpenEnded())
+        return;
+    if (!m_trace.isNull())
+        m_trace->record(QPageTrace::Estimate, estimate);
+
+    // The pages up to the current one are known to exist, even if the new estimate is smaller
+    m_estimatedCount = estimate > 0 ? estimate : 0;
+    updateTotalCount(qMax(m_estimatedCount, m_window.currentPage()));
+}
+
+bool QPageBar::isCountExact()
+{
+    return !m_window.isOpenEnded();
+}
+
+void QPageBar::updateTotalCount(qint64 totalCount)
 {
-    if (totalCount < showCount)
+    // 1. 只修改页面总数，如果当前页之后的页面没有了，当前页会被限制在范围内
+    int cellCount = m_window.cellCount();
+    bool changed = m_window.setTotalCount(totalCount);
+    if (m_autoShowCount)
+        fitShowCount();
+    updateCountLabel();
+
+    // 2. 只有格子数量变了才调整按钮池，否则只重新设置页码变了的按钮的文字
+    if (m_window.cellCount() != cellCount)
+        resizeButtonPool(m_window.cellCount());
+    updateButtons();
+    publishState();
+
+    if (changed && m_updateDepth == 0)
     {
-        qDebug() << "totalCount必须大于或等于showCount";
+        emit pageRequested(m_window.currentPage());
+        commitPage();
+    }
+}
+
+void QPageBar::updateCountLabel()
+{
+    // 在beginUpdate/endUpdate之间时，由endUpdate统一更新
+    if (m_updateDepth > 0)
+        return;
+
+    // 可以输入已知的页码，页数为估计值时也包括目前用>按钮到达的页码
+    m_pageValidator->setRange(1, m_window.totalCount());
+    if (m_window.isOpenEnded() && m_estimatedCount > 0)
+        m_countLabel->setText(tr(u8"约共%1页").arg(QLocale().toString(qMax(m_estimatedCount, m_window.totalCount()))));
+    else if (m_window.isOpenEnded())
+        m_countLabel->setText(tr(u8"第%1页，页数未知").arg(m_previewPage != 0 ? m_previewPage : m_window.currentPage()));
+    else
+        m_countLabel->setText(tr(u8"共") + QString::number(m_window.totalCount()) + tr(u8"页"));
+}
+
+void QPageBar::updatePageSizeBox()
+{
+    // 不在选项中的每页行数不选中任何一项
+    if (m_pageSizeBox != nullptr)
+        m_pageSizeBox->setCurrentIndex(m_pageSizeBox->findData(m_pageSize));
+}
+
+void QPageBar::updateScrubSlider()
+{
+    if (m_scrubSlider == nullptr || m_scrubSlider->isSliderDown())
+        return;
+
+    // 不超过ScrubSteps的页面每页对应一步，设置值时不激活valueChanged
+    QSignalBlocker blocker(m_scrubSlider);
+    qint64 last = qMax<qint64>(m_window.totalCount() - 1, 0);
+    int maximum = int(qMin<qint64>(last, ScrubSteps));
+    m_scrubSlider->setRange(0, maximum);
+    m_scrubSlider->setPageStep(qMax(maximum / 20, 1));
+    if (maximum == last)
+        m_scrubSlider->setValue(int(m_window.currentPage() - 1));
+    else
+        m_scrubSlider->setValue(qRound(double(m_window.currentPage() - 1) / last * maximum));
+    m_scrubSlider->setEnabled(last > 0 && !m_keysetMode);
+}
+
+qint64 QPageBar::scrubPage(int value) const
+{
+    qint64 last = m_window.totalCount() - 1;
+    int maximum = m_scrubSlider->maximum();
+    if (maximum == 0 || maximum == last)
+        return value + 1;
+    return 1 + qRound64(double(value) / maximum * last);
+}
+
+void QPageBar::previewPage(qint64 page)
+{
+    // 只有页码按钮和“第n页，页数未知”的页数标签跟随滑块，页面本身不变
+    if (page == m_previewPage || !m_window.contains(page))
         return;
+    m_previewPage = page;
+    if (m_window.isOpenEnded())
+        updateCountLabel();
+    updateButtons();
+}
+
+void QPageBar::finishScrub()
+{
+    // 页面仍然是拖动之前的页面，所以切换时只激活一次pageRequested和pageChanged
+    qint64 page = m_previewPage;
+    m_previewPage = 0;
+    if (page != 0 && page != m_window.currentPage() && isPageReachable(page))
+    {
+        setCurrentPage(page);
+    }
+    else
+    {
+        updateCountLabel();
+        updateButtons();
     }
+}
 
-    // 1. 首先要把原有的页码按钮清空
-    clear();
-    
-    // 2. 初始化成员变量
-    m_pageTotalCount = totalCount;
-    m_pageShowCount = showCount;
-    m_currentPage = 1;
-    m_pageStart = 1;
+void QPageBar::resizeButtonPool(int count)
+{
+    if (m_updateDepth > 0)
+        return;
 
-    m_countLabel->setText(tr(u8"共") + QString::number(m_pageTotalCount) + tr(u8"页"));
+    QHBoxLayout* hBoxLayout = qobject_cast<QHBoxLayout*>(layout());
 
-    // 3. 加入页码按钮，并且绑定信号
-    for (int i = 0; i < showCount; i++)
+    // 修改按钮时先禁用layout，最后只重新计算一次布局
+    hBoxLayout->setEnabled(false);
+
+    // 1. 创建池中缺少的按钮，并且绑定信号
+    for (int i = m_pageButtons.size(); i < count; i++)
     {
-        QFont font;
-        font.setPointSize(10);
-        QPushButton* button = new QPushButton(QString::number(i + 1), this);
-        button->setFont(font);
-        qobject_cast<QHBoxLayout*>(layout())->insertWidget(i + 3, button);
-        button->setWhatsThis(QString::number(i + 1));
+        QPushButton* button = new QPushButton(this);
+        button->setFont(m_font);
         button->setCheckable(true);
+        hBoxLayout->insertWidget(i + 3, button);
         m_pageButtons.append(button);
+        m_buttonPages.append(-1);
         connect(button, &QPushButton::clicked, this, &QPageBar::onButtonClicked);
     }
-    m_pageButtons[0]->setChecked(true);
+
+    // 2. 显示用到的按钮，其余的隐藏起来留给下一次setCount
+    for (int i = 0; i < m_pageButtons.size(); i++)
+    {
+        if (m_pageButtons[i]->isHidden() == (i < count))
+            m_pageButtons[i]->setVisible(i < count);
+    }
+
+    hBoxLayout->setEnabled(true);
+    hBoxLayout->activate();
 }
 
 void QPageBar::clear()
@@ -163,117 +384,794 @@ void QPageBar::clear()
         delete button;
     }
     m_pageButtons.clear();
-    m_pageShowCount = 0;
-    m_pageTotalCount = 0;
+    m_buttonPages.clear();
+    m_pageKeys.clear();
+    m_window.clear();
+    m_rowCount = -1;
+    m_quietTimer->stop();
+    m_maxDelayTimer->stop();
+    m_committedPage = m_window.currentPage();
+    updateButtons();
+    publishState();
 }
 
-int QPageBar::currentPage()
+qint64 QPageBar::currentPage()
 {
-    return m_currentPage;
+    return m_window.currentPage();
 }
 
-int QPageBar::pageCount()
+void QPageBar::setCurrentPage(qint64 page)
 {
-    return m_pageTotalCount;
+    // 和点击、跳转一样，键集分页只能打开已知游标的页面
+    if (!isPageReachable(page))
+    {
+        qDebug() << "键集分页只能打开访问过的页面和它们的相邻页面";
+        return;
+    }
+
+    // 代码设置的页面按跳转重放，这样之后的点击能找到同样的按钮
+    if (!m_trace.isNull())
+        m_trace->record(QPageTrace::Jump, page);
+    moveToPage(page);
 }
 
-void QPageBar::onButtonClicked(bool checked)
+void QPageBar::beginUpdate()
+{
+    // endUpdate之前不绘制
+    if (m_updateDepth++ == 0)
+        setUpdatesEnabled(false);
+}
+
+void QPageBar::endUpdate()
 {
-    if (m_pageTotalCount == 0 || m_pageShowCount == 0)
+    if (m_updateDepth == 0 || --m_updateDepth > 0)
         return;
 
-    int index = qobject_cast<QPushButton*>(sender())->whatsThis().toInt();
-    switch (index)
+    // 1. 页数标签、按钮池和按钮只更新一遍，然后重绘一次
+    updateCountLabel();
+    resizeButtonPool(m_window.cellCount());
+    updateButtons();
+    setUpdatesEnabled(true);
+    publishState();
+
+    // 2. 这一批中的页面切换不合并，直接用最后的页码提交
+    if (m_window.currentPage() != m_committedPage)
+    {
+        emit pageRequested(m_window.currentPage());
+        commitPage();
+    }
+}
+
+qint64 QPageBar::pageCount()
+{
+    return m_window.totalCount();
+}
+
+QPageBar::Snapshot QPageBar::snapshot() const
+{
+    // updateSnapshot在读取期间写入时重新读取
+    Snapshot snapshot;
+    quint32 sequence;
+    do
     {
-    case -1:    // -1是 < 按钮
-        if (m_currentPage == 1)
-            break;
-        // 如果当前页面不是显示的开头，直接切换即可
-        if (m_currentPage > m_pageStart)
+        sequence = m_snapshotSequence.load(std::memory_order_acquire);
+        snapshot.currentPage = m_snapshotPage.load(std::memory_order_relaxed);
+        snapshot.pageCount = m_snapshotCount.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((sequence & 1) != 0 || sequence != m_snapshotSequence.load(std::memory_order_relaxed));
+    return snapshot;
+}
+
+void QPageBar::postTotalCount(qint64 totalCount)
+{
+    // 覆盖还未应用的值，每轮只有第一次发送会把applyPosted排入队列
+    m_postedTotalCount.store(qMax<qint64>(totalCount, 0));
+    if (!m_applyQueued.exchange(true))
+        QMetaObject::invokeMethod(this, [this]() { applyPosted(); }, Qt::QueuedConnection);
+}
+
+void QPageBar::postCurrentPage(qint64 page)
+{
+    if (page < 1)
+        return;
+    m_postedPage.store(page);
+    if (!m_applyQueued.exchange(true))
+        QMetaObject::invokeMethod(this, [this]() { applyPosted(); }, Qt::QueuedConnection);
+}
+
+void QPageBar::setElided(bool elided)
+{
+    if (!m_trace.isNull())
+        m_trace->record(QPageTrace::Elided, elided);
+    m_window.setElided(elided);
+    if (m_autoShowCount)
+    {
+        m_fittedShowCount = 0;
+        fitShowCount();
+    }
+    resizeButtonPool(m_window.cellCount());
+    updateButtons();
+}
+
+bool QPageBar::isElided()
+{
+    return m_window.isElided();
+}
+
+void QPageBar::setAutoShowCount(bool autoShowCount)
+{
+    if (autoShowCount == m_autoShowCount)
+        return;
+    m_autoShowCount = autoShowCount;
+
+    // 否则布局会让pageBar至少和它的所有页码按钮一样宽，就再也无法缩小到更少的按钮
+    layout()->setSizeConstraint(m_autoShowCount ? QLayout::SetNoConstraint : QLayout::SetDefaultConstraint);
+    if (m_autoShowCount)
+    {
+        // 不再由宽度决定时恢复setCount的showCount和最小尺寸
+        m_manualShowCount = m_window.maxShowCount();
+        m_manualMinimumSize = minimumSize();
+        setMinimumSize(0, 0);
+        m_fittedShowCount = 0;
+        fitShowCount();
+    }
+    else
+    {
+        setMinimumSize(m_manualMinimumSize);
+        m_window.setShowCount(m_manualShowCount);
+    }
+    resizeButtonPool(m_window.cellCount());
+    updateButtons();
+    updateGeometry();
+}
+
+bool QPageBar::isAutoShowCount()
+{
+    return m_autoShowCount;
+}
+
+void QPageBar::setScrubSlider(bool enabled)
+{
+    if (enabled == (m_scrubSlider != nullptr))
+        return;
+    if (!enabled)
+    {
+        delete m_scrubSlider;
+        m_scrubSlider = nullptr;
+        if (m_previewPage != 0)
         {
-            m_pageButtons[m_currentPage - m_pageStart]->setChecked(false);
-            m_pageButtons[m_currentPage - m_pageStart - 1]->setChecked(true);
+            m_previewPage = 0;
+            updateCountLabel();
+            updateButtons();
         }
-        // 如果当前页面是显示的开头，就要整体往前切换
-        else
+        return;
+    }
+
+    // 1. 滑块紧跟在>按钮之后，所以页码按钮在布局中的位置不变
+    QHBoxLayout* hBoxLayout = qobject_cast<QHBoxLayout*>(layout());
+    m_scrubSlider = new QSlider(Qt::Horizontal, this);
+    m_scrubSlider->setMinimumWidth(100);
+    hBoxLayout->insertWidget(hBoxLayout->indexOf(m_nextButton) + 1, m_scrubSlider);
+
+    // 2. 拖动在松开之前只预览页面，点击滑槽和按键会立即切换页面
+    connect(m_scrubSlider, &QSlider::sliderReleased, this, &QPageBar::finishScrub);
+    connect(m_scrubSlider, &QSlider::valueChanged, this, [&](int value) {
+        if (m_scrubSlider->isSliderDown())
+            previewPage(scrubPage(value));
+        else if (isPageReachable(scrubPage(value)))
+            setCurrentPage(scrubPage(value));
+    });
+    updateScrubSlider();
+}
+
+bool QPageBar::hasScrubSlider()
+{
+    return m_scrubSlider != nullptr;
+}
+
+QSize QPageBar::minimumSizeHint() const
+{
+    // 自动模式下pageBar最窄可以缩小到一个页码按钮，省略布局中再加上第一页、最后一页和省略号
+    QSize size = QWidget::minimumSizeHint();
+    if (m_autoShowCount && m_cellWidth > 0)
+        size.setWidth(fixedWidth() + m_cellWidth * (m_window.isElided() ? 5 : 1));
+    return size;
+}
+
+void QPageBar::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+
+    // 只改变按钮池中按钮的可见性，并且只在能容纳的按钮数量变化时才改变
+    if (m_autoShowCount && fitShowCount())
+    {
+        resizeButtonPool(m_window.cellCount());
+        updateButtons();
+    }
+}
+
+bool QPageBar::eventFilter(QObject* watched, QEvent* event)
+{
+    // returnPressed只在输入可接受时激活，所以空的或者太小的页码会被悄悄忽略。改为由跳转按钮提示错误
+    if (watched == m_pageLineEdit && event->type() == QEvent::KeyPress)
+    {
+        int key = static_cast<QKeyEvent*>(event)->key();
+        if (key == Qt::Key_Return || key == Qt::Key_Enter)
         {
-            for (int i = 0; i < m_pageShowCount; i++)
-            {
-                m_pageButtons[i]->setWhatsThis(QString::number(m_pageStart + i - 1));
-                m_pageButtons[i]->setText(QString::number(m_pageStart + i - 1));
-                m_pageButtons[i]->setChecked(false);
-            }
-            m_pageButtons[0]->setChecked(true);
-            m_pageStart--;
+            m_jumpButton->click();
+            return true;
         }
-        m_currentPage--;
-        emit pageChanged(m_currentPage);
-        
-        // 如果已经到最末尾了就禁用>按钮，所以这里要恢复>按钮
-        m_nextButton->setEnabled(true);
-
-        // 如果到了最开头就禁用<按钮
-        if (m_currentPage == 1)
-            m_previousButton->setEnabled(false);
-
-        break;
-
-    case -2:    // -2是 > 按钮
-        if (m_currentPage == m_pageTotalCount)
-            break;
-        // 如果当前页面不是显示的结尾，直接切换即可
-        if (m_currentPage < m_pageStart + m_pageShowCount - 1)
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+void QPageBar::changeEvent(QEvent* event)
+{
+    QWidget::changeEvent(event);
+
+    // 不同的样式有不同的按钮边距
+    if (event->type() == QEvent::StyleChange && m_autoShowCount)
+    {
+        m_cellWidth = 0;
+        if (fitShowCount())
         {
-            m_pageButtons[m_currentPage - m_pageStart]->setChecked(false);
-            m_pageButtons[m_currentPage - m_pageStart + 1]->setChecked(true);
+            resizeButtonPool(m_window.cellCount());
+            updateButtons();
         }
-        // 如果当前页面是显示的结尾，就要整体往后切换
+    }
+}
+
+void QPageBar::setCoalescing(int quietTime, int maxDelay)
+{
+    // 定时器的间隔就是设置值，间隔为0表示不开启
+    m_quietTimer->setInterval(quietTime);
+    m_maxDelayTimer->setInterval(maxDelay);
+    if (quietTime == 0)
+        commitPage();
+}
+
+void QPageBar::setPageProvider(QPageProvider* provider)
+{
+    // 正在运行的请求属于旧的provider
+    m_pageWatcher->future().cancel();
+    m_pageWatcher->setFuture(QFuture<QVariant>());
+    setLoadingPage(0);
+    m_pageProvider = provider;
+}
+
+qint64 QPageBar::loadingPage()
+{
+    return m_loadingPage;
+}
+
+void QPageBar::reload()
+{
+    loadPage();
+}
+
+void QPageBar::setPageSize(qint64 pageSize)
+{
+    if (pageSize <= 0 || pageSize == m_pageSize)
+        return;
+    if (!m_trace.isNull())
+        m_trace->record(QPageTrace::PageSize, pageSize);
+
+    // 1. 修改之前显示的第一行，下拉框的每页行数随之改变
+    qint64 firstRow = (m_committedPage - 1) * m_pageSize;
+    bool anchored = m_rowCount >= 0 && m_pageSize > 0;
+    m_pageSize = pageSize;
+    updatePageSizeBox();
+
+    // 2. 键是按旧的每页行数报告的，不能标记新的页面
+    m_pageKeys.clear();
+    if (m_keyIndex != nullptr)
+        m_keyIndex->clear();
+
+    // 3. 知道行数时，在一批修改中重新得出页面数量，并把第一行所在的页面作为当前页。
+    //    键集分页已经没有这一页的游标，所以从第1页重新开始
+    if (anchored)
+    {
+        qint64 totalCount = (m_rowCount + m_pageSize - 1) / m_pageSize;
+        qint64 page = firstRow / m_pageSize + 1;
+        if (!isPageReachable(page))
+            page = 1;
+        beginUpdate();
+        updateTotalCount(totalCount);
+        moveToPage(page);
+
+        // 即使页号没有变化，这一页的行也变了，所以endUpdate会再次提交它
+        m_committedPage = 0;
+        endUpdate();
+    }
+    else
+    {
+        // 没有了键，能打开的页面变少了
+        updateButtons();
+    }
+    emit pageSizeChanged(m_pageSize);
+}
+
+qint64 QPageBar::pageSize()
+{
+    return m_pageSize;
+}
+
+void QPageBar::setPageSizeOptions(const QVector<qint64>& pageSizes)
+{
+    if (pageSizes.isEmpty())
+    {
+        delete m_pageSizeBox;
+        m_pageSizeBox = nullptr;
+        return;
+    }
+
+    // 1. 下拉框添加在布局的末尾，所以页码按钮在布局中的位置不变
+    if (m_pageSizeBox == nullptr)
+    {
+        m_pageSizeBox = new QComboBox(this);
+        m_pageSizeBox->setFont(m_font);
+        layout()->addWidget(m_pageSizeBox);
+        connect(m_pageSizeBox, QOverload<int>::of(&QComboBox::activated), this, [&](int index) {
+            setPageSize(m_pageSizeBox->itemData(index).toLongLong());
+        });
+    }
+
+    // 2. 还没有每页行数时，像在下拉框中选择一样设置第一个选项，所以pageSizeChanged和trace都能看到它
+    if (m_pageSize <= 0)
+        setPageSize(pageSizes.first());
+
+    // 3. 填入选项并选中当前的每页行数
+    m_pageSizeBox->clear();
+    for (qint64 pageSize : pageSizes)
+        m_pageSizeBox->addItem(tr(u8"%1 条/页").arg(pageSize), pageSize);
+    updatePageSizeBox();
+}
+
+void QPageBar::setKeysetMode(bool keysetMode)
+{
+    if (!m_trace.isNull())
+        m_trace->record(QPageTrace::KeysetMode, keysetMode);
+    m_keysetMode = keysetMode;
+    updateButtons();
+}
+
+bool QPageBar::isKeysetMode()
+{
+    return m_keysetMode;
+}
+
+void QPageBar::setPageKeys(qint64 page, const QVariant& firstKey, const QVariant& lastKey)
+{
+    m_pageKeys.insert(page, qMakePair(firstKey, lastKey));
+    updateButtons();
+}
+
+void QPageBar::clearPageKeys()
+{
+    m_pageKeys.clear();
+    updateButtons();
+}
+
+void QPageBar::setKeyIndex(QPageKeyIndex* index)
+{
+    m_keyIndex = index;
+    // 键不是页码
+    m_pageLineEdit->setValidator(m_keyIndex != nullptr ? nullptr : m_pageValidator);
+}
+
+qint64 QPageBar::jumpToKey(const QVariant& key)
+{
+    if (m_keyIndex == nullptr)
+        return 0;
+
+    // 和跳转到页码一样移动窗口
+    m_keyIndex->setPageCount(m_window.totalCount());
+    qint64 page = m_keyIndex->pageOf(key);
+    if (!m_window.contains(page) || !isPageReachable(page))
+        return 0;
+    if (!m_trace.isNull())
+        m_trace->record(QPageTrace::Jump, page);
+    moveToPage(page);
+    return page;
+}
+
+void QPageBar::setLatencyTracking(bool enabled)
+{
+    if (enabled && m_latencyTracker == nullptr)
+    {
+        m_latencyTracker = new QPageLatencyTracker(this);
+    }
+    else if (!enabled)
+    {
+        delete m_latencyTracker;
+        m_latencyTracker = nullptr;
+    }
+}
+
+QPageLatencyTracker* QPageBar::latencyTracker()
+{
+    return m_latencyTracker;
+}
+
+void QPageBar::setTraceDevice(QIODevice* device)
+{
+    // 新的设备开始一个新的trace，带有自己的头部
+    m_trace.reset(device != nullptr ? new QPageTrace(device) : nullptr);
+
+    // trace以当前的设置、页数和页码开始，这样重放时能找到同样的按钮
+    if (m_trace.isNull())
+        return;
+    if (m_pageSize > 0)
+        m_trace->record(QPageTrace::PageSize, m_pageSize);
+    if (m_window.isElided())
+        m_trace->record(QPageTrace::Elided, 1);
+    if (m_keysetMode)
+        m_trace->record(QPageTrace::KeysetMode, 1);
+    if (!m_window.isEmpty())
+    {
+        if (m_window.isOpenEnded())
+            m_trace->record(QPageTrace::EstimatedCount, m_window.totalCount(), m_window.showCount());
+        else if (m_rowCount >= 0)
+            m_trace->record(QPageTrace::RowCount, m_rowCount, m_window.showCount());
         else
-        {
-            for (int i = 0; i < m_pageShowCount; i++)
-            {
-                m_pageButtons[i]->setWhatsThis(QString::number(m_pageStart + i + 1));
-                m_pageButtons[i]->setText(QString::number(m_pageStart + i + 1));
-                m_pageButtons[i]->setChecked(false);
-            }
-            m_pageButtons[m_pageShowCount - 1]->setChecked(true);
-            m_pageStart++;
-        }
-        m_currentPage++;
-        emit pageChanged(m_currentPage);
+            m_trace->record(QPageTrace::Count, m_window.totalCount(), m_window.showCount());
+        if (m_window.currentPage() != 1)
+            m_trace->record(QPageTrace::Jump, m_window.currentPage());
+    }
+}
 
-        // 如果已经到最开头了就禁用<按钮，所以这里要恢复<按钮
-        m_previousButton->setEnabled(true);
+void QPageBar::setModel(QPageBarModel* model)
+{
+    if (m_model != nullptr)
+        disconnect(m_model, nullptr, this, nullptr);
+    m_model = model;
+    if (m_model == nullptr)
+        return;
 
-        // 如果到了最末尾就禁用>按钮
-        if (m_currentPage == m_pageTotalCount)
-            m_nextButton->setEnabled(false);
+    connect(m_model, &QPageBarModel::stateChanged, this, &QPageBar::onModelStateChanged);
+    connect(m_model, &QObject::destroyed, this, [this]() { m_model = nullptr; });
+    // 第一个pageBar填充空的model，之后的pageBar显示它的页面
+    if (m_model->window().isEmpty())
+        publishState();
+    else
+        onModelStateChanged(nullptr);
+}
 
-        break;
+QPageBarModel* QPageBar::model()
+{
+    return m_model;
+}
 
-    default:    // 其他都是页号按钮
-        m_pageButtons[index - m_pageStart]->setChecked(true);
-        if (index == m_currentPage)
-            break;
-        m_pageButtons[m_currentPage - m_pageStart]->setChecked(false);
-        if (index == 1)
-        {
-            m_previousButton->setEnabled(false);
-            m_nextButton->setEnabled(true);
-        }
-        else if (index == m_pageTotalCount)
+void QPageBar::pageReady(qint64 page)
+{
+    if (m_latencyTracker != nullptr)
+        m_latencyTracker->markReady(page);
+}
+
+bool QPageBar::isPageReachable(qint64 page)
+{
+    // 第1页从第一行开始，其他页面需要自己的键或者相邻页面的键
+    return !m_keysetMode || page == 1 || m_pageKeys.contains(page) || m_pageKeys.contains(page - 1) || m_pageKeys.contains(page + 1);
+}
+
+void QPageBar::requestKeyset()
+{
+    qint64 page = m_committedPage;
+
+    // 优先使用这一页自己的第一个键，其次是前一页的最后一个键，再次是后一页的第一个键
+    auto keys = m_pageKeys.constFind(page);
+    if (keys != m_pageKeys.constEnd())
+    {
+        emit keysetRequested(page, keys->first, SeekFrom);
+        return;
+    }
+    keys = m_pageKeys.constFind(page - 1);
+    if (keys != m_pageKeys.constEnd())
+    {
+        emit keysetRequested(page, keys->second, SeekAfter);
+        return;
+    }
+    keys = m_pageKeys.constFind(page + 1);
+    if (keys != m_pageKeys.constEnd())
+    {
+        emit keysetRequested(page, keys->first, SeekBefore);
+        return;
+    }
+    emit keysetRequested(page, QVariant(), SeekFrom);
+}
+
+void QPageBar::onButtonClicked(bool checked)
+{
+    if (m_window.isEmpty())
+        return;
+
+    QPushButton* button = qobject_cast<QPushButton*>(sender());
+    if (button == m_previousButton)
+    {
+        if (!m_trace.isNull())
+            m_trace->record(QPageTrace::Previous);
+        moveToPage(m_window.currentPage() - 1);
+    }
+    else if (button == m_nextButton)
+    {
+        if (!m_trace.isNull())
+            m_trace->record(QPageTrace::Next);
+        // 页面总数不确定时，认为最后一页之后还有下一页，直到setTotalCount给出结尾
+        if (m_window.isOpenEnded() && m_window.currentPage() == m_window.totalCount())
+            updateTotalCount(m_window.totalCount() + 1);
+        moveToPage(m_window.currentPage() + 1);
+    }
+    else    // 其他都是页号按钮，页码由按钮在窗口中的位置决定
+    {
+        qint64 page = m_window.cellPage(int(m_pageButtons.indexOf(button)));
+        if (!m_trace.isNull())
+            m_trace->record(QPageTrace::Page, page);
+        moveToPage(page);
+    }
+}
+
+void QPageBar::moveToPage(qint64 page)
+{
+    if (m_latencyTracker != nullptr)
+        m_latencyTracker->markInput();
+
+    bool changed = m_window.setCurrentPage(page);
+
+    // 无论是否切换都要更新按钮：点击已选中的页码按钮会取消它的选中状态
+    updateButtons();
+    if (!changed || m_updateDepth > 0)
+        return;
+    publishState();
+
+    // "第n页，页数未知"中显示了当前页
+    if (m_window.isOpenEnded())
+        updateCountLabel();
+
+    emit pageRequested(m_window.currentPage());
+
+    // 开启合并时，pageChanged要等到页面不再切换
+    if (m_quietTimer->interval() > 0)
+    {
+        m_quietTimer->start();
+        if (m_maxDelayTimer->interval() > 0 && !m_maxDelayTimer->isActive())
+            m_maxDelayTimer->start();
+    }
+    else
+    {
+        commitPage();
+    }
+}
+
+void QPageBar::commitPage()
+{
+    if (m_updateDepth > 0)
+        return;
+
+    m_quietTimer->stop();
+    m_maxDelayTimer->stop();
+
+    // 切换回已提交的页面不需要再激活pageChanged
+    if (m_committedPage == m_window.currentPage())
+        return;
+    m_committedPage = m_window.currentPage();
+    if (m_latencyTracker != nullptr)
+        m_latencyTracker->markChanged(m_committedPage);
+    emit pageChanged(m_committedPage);
+    if (m_latencyTracker != nullptr)
+        m_latencyTracker->markDispatched();
+    if (m_model != nullptr)
+        m_model->commitPage(m_committedPage);
+    if (m_pageSize > 0)
+        emit pageRangeChanged((m_committedPage - 1) * m_pageSize, m_pageSize);
+    if (m_keysetMode)
+        requestKeyset();
+    loadPage();
+}
+
+void QPageBar::loadPage()
+{
+    if (m_pageProvider == nullptr)
+        return;
+
+    // 取消上一页的请求，setFuture也会丢弃它还没处理的finished信号
+    m_pageWatcher->future().cancel();
+    qint64 page = m_committedPage;
+    m_pageWatcher->setFuture(m_pageProvider->requestPage(page));
+    setLoadingPage(page);
+}
+
+void QPageBar::onPageLoaded()
+{
+    QFuture<QVariant> future = m_pageWatcher->future();
+    qint64 page = m_loadingPage;
+    setLoadingPage(0);
+
+    // 被取消的请求、失败的请求以及不再是当前页的请求都是过期的
+    if (future.isCanceled() || future.resultCount() == 0 || page != m_committedPage)
+        return;
+    emit pageLoaded(page, future.result());
+}
+
+void QPageBar::setLoadingPage(qint64 page)
+{
+    m_loadingPage = page;
+    updateButtons();
+}
+
+bool QPageBar::fitShowCount()
+{
+    int showCount = fittedShowCount();
+    if (showCount == m_fittedShowCount)
+        return false;
+    m_fittedShowCount = showCount;
+    m_window.setShowCount(showCount);
+    return true;
+}
+
+int QPageBar::fittedShowCount()
+{
+    // 1. 最大页码的按钮宽度，每种位数只测量一次
+    int digits = int(QString::number(qMax<qint64>(m_window.totalCount(), 1)).size());
+    if (m_cellWidth == 0 || digits != m_cellDigits)
+    {
+        QFontMetrics fontMetrics(m_font);
+        QStyleOptionButton option;
+        option.initFrom(m_previousButton);
+        option.fontMetrics = fontMetrics;
+        option.text = QString(digits, QLatin1Char('0'));
+        QSize textSize = fontMetrics.size(Qt::TextShowMnemonic, option.text);
+        m_cellWidth = style()->sizeFromContents(QStyle::CT_PushButton, &option, textSize, m_previousButton).width() + layout()->spacing();
+        m_cellDigits = digits;
+        updateGeometry();
+    }
+
+    // 2. 页码按钮分享其他控件剩下的宽度，省略布局需要其中4个用于第一页、最后一页和省略号
+    int showCount = (width() - fixedWidth()) / m_cellWidth;
+    if (m_window.isElided())
+        showCount -= 4;
+    return qMax(showCount, 1);
+}
+
+int QPageBar::fixedWidth() const
+{
+    QHBoxLayout* hBoxLayout = qobject_cast<QHBoxLayout*>(layout());
+    QMargins margins = hBoxLayout->contentsMargins();
+    int width = margins.left() + margins.right();
+
+    // 页码按钮插在弹簧、页数标签和<按钮之后。隐藏的控件和弹簧不占宽度
+    for (int i = 0; i < hBoxLayout->count(); i++)
+    {
+        QLayoutItem* item = hBoxLayout->itemAt(i);
+        if ((i >= 3 && i < 3 + m_pageButtons.size()) || item->isEmpty())
+            continue;
+        width += item->sizeHint().width() + hBoxLayout->spacing();
+    }
+    return width;
+}
+
+void QPageBar::setInputError(const QString& message)
+{
+    // 用提示代替模态的消息框，这样事件循环以及加载和定时器都能继续运行
+    bool error = !message.isEmpty();
+    m_pageLineEdit->setToolTip(message);
+    if (error)
+        QToolTip::showText(m_pageLineEdit->mapToGlobal(QPoint(0, m_pageLineEdit->height())), message, m_pageLineEdit);
+
+    // "error"属性可以在样式表中使用，比如QLineEdit[error="true"] { border: 1px solid red; }
+    if (m_pageLineEdit->property("error").toBool() != error)
+    {
+        m_pageLineEdit->setProperty("error", error);
+        if (!error)
+            QToolTip::hideText();
+        m_pageLineEdit->style()->unpolish(m_pageLineEdit);
+        m_pageLineEdit->style()->polish(m_pageLineEdit);
+    }
+}
+
+void QPageBar::publishState()
+{
+    // 在beginUpdate/endUpdate之间时，endUpdate会一次性报告最后的页面
+    if (m_model != nullptr && m_updateDepth == 0)
+        m_model->setState(m_window, m_estimatedCount, this);
+}
+
+void QPageBar::onModelStateChanged(QObject* source)
+{
+    if (source == this)
+        return;
+
+    // 1. 使用共享的页面，布局和页号按钮的数量仍然是这个pageBar自己的。重放时把同样的页面交给它的模型
+    if (!m_trace.isNull())
+        m_trace->recordModelState(m_model->window(), m_model->estimatedCount());
+    bool elided = m_window.isElided();
+    int showCount = m_window.maxShowCount();
+    m_window = m_model->window();
+    m_window.setShowCount(showCount);
+    m_window.setElided(elided);
+    if (m_autoShowCount)
+    {
+        m_fittedShowCount = 0;
+        fitShowCount();
+    }
+    m_estimatedCount = m_model->estimatedCount();
+
+    // 2. 页面切换属于其他pageBar，所以丢弃这个pageBar还未激活的pageChanged，也不激活新的
+    m_quietTimer->stop();
+    m_maxDelayTimer->stop();
+    m_committedPage = m_window.currentPage();
+
+    updateCountLabel();
+    resizeButtonPool(m_window.cellCount());
+    updateButtons();
+}
+
+void QPageBar::applyPosted()
+{
+    // 1. 从现在起的发送会排入下一次应用，不会遗漏任何值
+    m_applyQueued.store(false);
+    qint64 totalCount = m_postedTotalCount.exchange(-1);
+    qint64 page = m_postedPage.exchange(0);
+
+    // 2. 先应用页面数量，使页面在范围内，并且最多激活一次pageChanged
+    beginUpdate();
+    if (totalCount >= 0)
+        setTotalCount(totalCount);
+    if (page > 0 && page <= m_window.totalCount())
+        setCurrentPage(page);
+    endUpdate();
+}
+
+void QPageBar::updateSnapshot()
+{
+    // 只有一个写入者的seqlock，见snapshot
+    quint32 sequence = m_snapshotSequence.load(std::memory_order_relaxed);
+    m_snapshotSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_snapshotPage.store(m_window.currentPage(), std::memory_order_relaxed);
+    m_snapshotCount.store(m_window.totalCount(), std::memory_order_relaxed);
+    m_snapshotSequence.store(sequence + 2, std::memory_order_release);
+}
+
+void QPageBar::updateButtons()
+{
+    if (m_updateDepth > 0)
+        return;
+
+    updateSnapshot();
+
+    // 拖动滑块时，按钮按页面的一个副本绘制，副本位于预览的页面
+    PageWindow window = m_window;
+    if (m_previewPage != 0)
+        window.setCurrentPage(m_previewPage);
+
+    for (int i = 0; i < window.cellCount(); i++)
+    {
+        // 只有页码变了的按钮才重新设置文字，省略号是禁用的按钮
+        qint64 page = window.cellPage(i);
+        if (m_buttonPages[i] != page)
         {
-            m_nextButton->setEnabled(false);
-            m_previousButton->setEnabled(true);
+            m_buttonPages[i] = page;
+            m_pageButtons[i]->setText(page == 0 ? QString(QChar(0x2026)) : QString::number(page));
         }
-        else
+        m_pageButtons[i]->setEnabled(page != 0 && isPageReachable(page));
+        m_pageButtons[i]->setChecked(page == window.currentPage());
+
+        // 正在加载的页面的按钮有"loading"属性，可以在样式表中使用
+        bool loading = m_loadingPage != 0 && page == m_loadingPage;
+        if (m_pageButtons[i]->property("loading").toBool() != loading)
         {
-            m_previousButton->setEnabled(true);
-            m_nextButton->setEnabled(true);
+            m_pageButtons[i]->setProperty("loading", loading);
+            if (loading)
+                m_pageButtons[i]->setCursor(Qt::BusyCursor);
+            else
+                m_pageButtons[i]->unsetCursor();
+            m_pageButtons[i]->style()->unpolish(m_pageButtons[i]);
+            m_pageButtons[i]->style()->polish(m_pageButtons[i]);
         }
-        m_currentPage = index;
-        emit pageChanged(m_currentPage);
-
-        break;
     }
+
+    // 第一页时禁用<按钮，最后一页时禁用>按钮
+    m_previousButton->setEnabled(window.canGoPrevious() && isPageReachable(window.currentPage() - 1));
+    m_nextButton->setEnabled(window.canGoNext() && isPageReachable(window.currentPage() + 1));
+    updateScrubSlider();
 }
@@ -5,7 +5,24 @@
 #include <QPushButton>
 #include <QLabel>
 #include <QLineEdit>
+#include <QComboBox>
+#include <QSlider>
 #include <QVector>
+#include <QTimer>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QPair>
+#include <QVariant>
+#include <QScopedPointer>
+#include <atomic>
+
+#include "pagewindow.h"
+#include "qpageprovider.h"
+#include "qpagekeyindex.h"
+#include "qpagelatency.h"
+#include "qpagetrace.h"
+#include "qpagebarmodel.h"
+#include "qpagenumbervalidator.h"
 
 /**
 * @brief 这个类是切换页码的控件，类似于论坛最下面的那种
@@ -14,6 +31,17 @@ class QPageBar : public QWidget
 {
     Q_OBJECT
 public:
+    /**
+    * @brief 键集模式中keysetRequested查找一页的行的方式
+    */
+    enum KeysetSeek
+    {
+        SeekFrom,       // 键 >= 这一页自己的第一个键的行，键无效时从第一行开始
+        SeekAfter,      // 键 > 前一页最后一个键的行
+        SeekBefore      // 键 < 后一页第一个键的行，按降序
+    };
+    Q_ENUM(KeysetSeek)
+
     explicit QPageBar(QWidget* parent = nullptr);
     
     /**
@@ -21,17 +49,63 @@ public:
     * @param pageTotalCount 全部的页面数量
     * @param pageShowCount 显示的页码按钮数量 
     */
-    explicit QPageBar(int pageTotalCount, int pageShowCount = 5, QWidget* parent = nullptr);
+    explicit QPageBar(qint64 pageTotalCount, int pageShowCount = 5, QWidget* parent = nullptr);
 
     /**
-    * @brief 设置页面的数量，totalCount必须大于等于showCount
+    * @brief 设置页面的数量。showCount不会超过totalCount，setTotalCount增加页面总数时会恢复，
+    *        所以可以用setCount(0, showCount)开始。已有的页码按钮会被复用，所以频繁调用的开销很小
     * @param totalCount 全部的页面数量
     * @param showCount 显示的页码按钮数量
     */
-    void setCount(int totalCount, int showCount);
+    void setCount(qint64 totalCount, int showCount);
+
+    /**
+    * @brief 设置行的总数而不是页面的数量，页面数量由setPageSize得出。和setCount一样回到第1页。
+    *        与setCount不同，之后修改每页的行数时当前的行仍然可见，见setPageSize
+    * @param rowCount 全部的行数
+    * @param showCount 显示的页码按钮数量
+    */
+    void setRowCount(qint64 rowCount, int showCount);
+
+    /**
+    * @brief 获取setRowCount的行数
+    * @return 行数，页面数量是按页设置的时返回-1
+    */
+    qint64 rowCount();
+
+    /**
+    * @brief 只修改页面总数，比如流式查询还在不断增加结果集时。
+    *        当前页和页码按钮保持不变，只更新页数标签和>按钮。
+    *        页面总数小于页码按钮数量时，多余的按钮会被隐藏，总数增加后再显示出来。
+    *        如果当前页已经不存在，最后一页成为当前页，并激活pageChanged。
+    *        setEstimatedCount之后，通过它给出准确的页面总数，结束估计模式
+    * @param totalCount 全部的页面数量，0表示没有页面
+    */
+    void setTotalCount(qint64 totalCount);
+
+    /**
+    * @brief 在知道准确的页面总数之前显示pageBar，比如不用先执行COUNT(*)。和setCount一样回到第1页。
+    *        页数标签显示"约estimate页"，estimate为0时显示"第n页，页数未知"，最后一页上>按钮仍然可用，每次增加一页，
+    *        直到setTotalCount给出准确的页面总数
+    * @param estimate 估计的页面总数，未知时为0
+    * @param showCount 显示的页码按钮数量
+    */
+    void setEstimatedCount(qint64 estimate, int showCount);
 
     /**
-    * @brief 清空页面按钮和数量
+    * @brief 修正setEstimatedCount的估计值，和setTotalCount一样保留当前页和页码按钮。
+    *        已经知道准确的页面总数时忽略
+    * @param estimate 估计的页面总数，未知时为0
+    */
+    void setEstimate(qint64 estimate);
+
+    /**
+    * @brief 页面总数是否是准确的，setEstimatedCount之后、setTotalCount或setCount之前为false
+    */
+    bool isCountExact();
+
+    /**
+    * @brief 清空页面数量并删除页码按钮，包括setCount留着复用的按钮
     */
     void clear();
 
@@ -39,20 +113,250 @@ public:
     * @brief 获取当前页面号
     * @return 当前页号
     */
-    int currentPage();
+    qint64 currentPage();
+
+    /**
+    * @brief 在代码中切换到指定的页面，比如恢复视图时。和点击一样激活pageChanged
+    * @param page 页号，必须在1~totalCount之内。键集分页时必须是第1页、访问过的页面或者它们的相邻页面
+    */
+    void setCurrentPage(qint64 page);
+
+    /**
+    * @brief 开始一批修改，比如setCount之后再setCurrentPage。在对应的endUpdate之前，
+    *        按钮不会更新，也不会激活信号。可以嵌套调用，只有最外层的endUpdate才会结束这一批修改
+    */
+    void beginUpdate();
+
+    /**
+    * @brief 结束一批修改：页数标签和按钮只更新、重绘一次，
+    *        pageRequested和pageChanged最多用最后的页码激活一次
+    */
+    void endUpdate();
 
     /**
     * @brief 获取页面数量
     * @return 页面数量
     */
-    int pageCount();
+    qint64 pageCount();
+
+    /**
+    * @brief 同一时刻的当前页和页面数量，见snapshot
+    */
+    struct Snapshot
+    {
+        qint64 currentPage;
+        qint64 pageCount;
+    };
+
+    /**
+    * @brief 线程安全：获取按钮显示的当前页和页面数量，例如在工作线程中。
+    *        两个值属于同一个状态，读取时不加锁
+    */
+    Snapshot snapshot() const;
+
+    /**
+    * @brief 线程安全：从任意线程报告页面数量，例如从导入数据行的工作线程。
+    *        只保留最新的值，它在pageBar所在的线程中每轮事件循环最多用setTotalCount应用一次，
+    *        所以工作线程发送的频率可以远高于pageBar重建的频率。pageBar的生命周期必须长于这次调用
+    * @param totalCount 页面数量，为0时没有页面
+    */
+    void postTotalCount(qint64 totalCount);
+
+    /**
+    * @brief 线程安全：从任意线程切换到指定的页面。像setCurrentPage一样应用，在同一轮发送的页面数量之后
+    * @param page 页号
+    */
+    void postCurrentPage(qint64 page);
+
+    /**
+    * @brief 切换到省略布局"1 … 498 499 [500] 501 502 … 1000000"，显示当前页周围的showCount个页面以及第一页和最后一页。
+    *        按钮的数量固定不变，只有页码变了的按钮才会重新设置文字
+    * @param elided 是否使用省略布局
+    */
+    void setElided(bool elided);
+    bool isElided();
+
+    /**
+    * @brief 根据可用的宽度决定页码按钮的数量，而不是使用setCount的showCount。最大页码的按钮宽度会被缓存，
+    *        改变大小时只会显示或隐藏按钮池中的按钮，所以很多pageBar也能流畅地改变大小。
+    *        此时pageBar最窄可以缩小到只有一个页码按钮。关闭时恢复setCount的showCount和最小尺寸
+    * @param autoShowCount 是否让页码按钮适应宽度
+    */
+    void setAutoShowCount(bool autoShowCount);
+    bool isAutoShowCount();
+
+    /**
+    * @brief 在>按钮之后显示一个滑块，用于在大量页面之间移动。拖动时页码按钮预览滑块所在的页面，不激活任何信号，
+    *        松开时才切换一次页面，所以很长的拖动也只加载一页。在此之前currentPage和snapshot仍然是拖动之前的页面。点击滑槽和方向键会立即切换页面。
+    *        页面多于滑块的步数时，每一步跳过多个页面
+    * @param enabled 是否显示滑块
+    */
+    void setScrubSlider(bool enabled);
+    bool hasScrubSlider();
+
+    QSize minimumSizeHint() const override;
+
+    /**
+    * @brief 合并页面切换：每次切换仍然会激活pageRequested，但pageChanged只在最后的页面上激活，
+    *        即连续quietTime毫秒没有切换页面，或者最迟在第一次切换后maxDelay毫秒
+    * @param quietTime 静默时间（毫秒），为0时不合并，每次切换都激活pageChanged
+    * @param maxDelay 最大延迟（毫秒），为0时没有最大延迟
+    */
+    void setCoalescing(int quietTime, int maxDelay = 0);
+
+    /**
+    * @brief 设置加载页面的provider。每次激活pageChanged时都会向provider请求这一页，
+    *        还在运行的请求会被取消，页码按钮显示加载状态直到pageLoaded
+    * @param provider provider，pageBar不负责释放。为nullptr时移除provider
+    */
+    void setPageProvider(QPageProvider* provider);
+
+    /**
+    * @brief 获取provider正在加载的页面
+    * @return 页号，没有正在加载的页面时返回0
+    */
+    qint64 loadingPage();
+
+    /**
+    * @brief 重新向provider请求当前页，例如数据改变后，或者回到第1页但不激活pageChanged的setCount之后
+    */
+    void reload();
+
+    /**
+    * @brief 设置每页的行数。如果大于0，会和pageChanged一起激活pageRangeChanged。
+    *        调用过setRowCount时，会重新得出页面数量，并把包含当前页第一行的页面作为当前页，
+    *        然后激活一次pageChanged和pageRangeChanged，即使页号没有变化。
+    *        否则页面数量由调用者负责，比如在连接到pageSizeChanged的槽函数中。
+    *        setPageKeys的键和键索引会被清除，所以在键集分页中，调用过setRowCount时当前页是第1页
+    * @param pageSize 每页的行数，必须大于0
+    */
+    void setPageSize(qint64 pageSize);
+    qint64 pageSize();
+
+    /**
+    * @brief 在pageBar的末尾显示选择每页行数的下拉框，它会调用setPageSize。
+    *        还没有设置每页的行数时，第一个选项成为每页的行数，并激活pageSizeChanged
+    * @param pageSizes 可选的每页行数，比如{25, 50, 100, 500}。为空时移除下拉框
+    */
+    void setPageSizeOptions(const QVector<qint64>& pageSizes);
+
+    /**
+    * @brief 切换到键集分页：keysetRequested传递的不是偏移量，而是从setPageKeys报告的键中得到的、用来查找这一页的游标。
+    *        只能打开游标已知的页面，即第1页、访问过的页面以及它们相邻的页面，所以在报告当前页的键之前</>按钮是禁用的
+    * @param keysetMode 是否使用键集分页
+    */
+    void setKeysetMode(bool keysetMode);
+    bool isKeysetMode();
+
+    /**
+    * @brief 报告已加载的页面的第一个和最后一个键，它们成为这一页和相邻页面的游标
+    * @param page 页号
+    * @param firstKey 这一页第一行的键
+    * @param lastKey 这一页最后一行的键
+    */
+    void setPageKeys(qint64 page, const QVariant& firstKey, const QVariant& lastKey);
+
+    /**
+    * @brief 清除所有的键，比如数据改变之后。setCount也会清除
+    */
+    void clearPageKeys();
+
+    /**
+    * @brief 设置跳转到某个键时使用的索引。设置后页码输入框中的文字会作为键（比如客户ID或者时间戳）查找，而不是页码
+    * @param index 索引，不归pageBar所有。nullptr表示回到页码
+    */
+    void setKeyIndex(QPageKeyIndex* index);
+
+    /**
+    * @brief 切换到包含key的页面，通过setKeyIndex的索引在O(log n)内找到
+    * @param key 要查找的键
+    * @return 页号，没有设置索引、找不到页面或者在键集模式中不能打开时返回0
+    */
+    qint64 jumpToKey(const QVariant& key);
+
+    /**
+    * @brief 测量每次导航花费的时间：从输入到pageChanged、连接到pageChanged的槽函数，
+    *        以及从pageChanged到pageReady。禁用时每次导航只多一次指针判断
+    * @param enabled 是否测量，禁用时会丢弃收集到的延迟
+    */
+    void setLatencyTracking(bool enabled);
+
+    /**
+    * @brief setLatencyTracking(true)以来收集到的延迟
+    * @return 归pageBar所有的tracker，禁用时返回nullptr
+    */
+    QPageLatencyTracker* latencyTracker();
+
+    /**
+    * @brief 把每次点击、跳转和页数变化连同时间戳记录到紧凑的二进制trace中，见QPageTrace。
+    *        trace可以用tools/QPageBarReplay在无界面的情况下重放，比如用来重现一次很慢的操作。
+    *        没有设置device时每次导航只多一次指针判断
+    * @param device 写入的已打开的设备，不归pageBar所有。nullptr停止记录
+    */
+    void setTraceDevice(QIODevice* device);
+
+    /**
+    * @brief 和其他pageBar共享页面，比如表格上方和下方各有一个。任何一个pageBar中的导航都会显示在所有pageBar上，
+    *        并且model只为它激活一次pageChanged，所以后端应连接到model上。只有进行导航的pageBar会激活自己的信号，
+    *        并从它的provider请求页面，其他pageBar只是跟随。
+    *        第一个pageBar会把自己的页面填入空的model，之后的pageBar会使用model中的页面
+    * @param model model，不归pageBar所有。nullptr会解除关联，pageBar保留当前的页面
+    */
+    void setModel(QPageBarModel* model);
+    QPageBarModel* model();
+
+public slots:
+    /**
+    * @brief 报告page的内容已经显示出来了，对延迟测量来说这次导航到此结束
+    * @param page 页号
+    */
+    void pageReady(qint64 page);
 
 signals:
     /**
-    * @brief 当页面切换时，激活这一信号
+    * @brief 当页面切换时，激活这一信号。如果开启了合并，只在最后的页面上激活
+    * @param page 页号
+    */
+    void pageChanged(qint64 page);
+
+    /**
+    * @brief 每次切换页面时立即激活这一信号，开启了合并也一样
+    * @param page 页号
+    */
+    void pageRequested(qint64 page);
+
+    /**
+    * @brief 设置了每页的行数时，和pageChanged一起激活这一信号，参数可以直接用于LIMIT/OFFSET
+    * @param offset 这一页第一行的下标，即(page - 1) * pageSize
+    * @param limit 每页的行数
+    */
+    void pageRangeChanged(qint64 offset, qint64 limit);
+
+    /**
+    * @brief 每页的行数改变时激活这一信号，比如在setPageSizeOptions的下拉框中选择时
+    * @param pageSize 每页的行数
+    */
+    void pageSizeChanged(qint64 pageSize);
+
+    /**
+    * @brief 键集模式中和pageChanged一起激活这一信号，参数可以用于键上的WHERE子句
+    * @param page 页号
+    * @param key 开始查找的游标，第一页时无效
+    * @param seek 从游标查找这一页的行的方式
+    */
+    void keysetRequested(qint64 page, const QVariant& key, QPageBar::KeysetSeek seek);
+
+    /**
+    * @brief provider加载完当前页时，激活这一信号。被取消的或过期的请求的结果会被丢弃
     * @param page 页号
+    * @param data provider的结果
     */
-    void pageChanged(int page);
+    void pageLoaded(qint64 page, const QVariant& data);
+
+protected:
+    void resizeEvent(QResizeEvent* event) override;
+    void changeEvent(QEvent* event) override;
+    bool eventFilter(QObject* watched, QEvent* event) override;
 
 protected slots:
     /**
@@ -63,31 +367,289 @@ protected slots:
 
 private:
     /**
-    * @brief 页面总数
+    * @brief 切换到指定的页面，4种页码跳转的方式都通过这个函数
+    * @param page 页号
     */
-    int m_pageTotalCount;
+    void moveToPage(qint64 page);
 
     /**
-    * @brief 在pageBar中显示的页面数
+    * @brief 用给定的页面数量回到第1页，setCount和setEstimatedCount共用
     */
-    int m_pageShowCount;
+    void resetCount(qint64 totalCount, int showCount);
 
     /**
-    * @brief 显示的页面中最左面的（也就是最小的）页码
+    * @brief 不离开当前页地修改页面数量，setTotalCount、setEstimate和>按钮共用
     */
-    int m_pageStart;
+    void updateTotalCount(qint64 totalCount);
 
     /**
-    * @brief 当前选中的页码
+    * @brief 在页数标签中显示页面总数，并把页码输入框限制在这些页面之内
     */
-    int m_currentPage;
+    void updateCountLabel();
+
+    /**
+    * @brief 在setPageSizeOptions的下拉框中选中当前的每页行数，如果有下拉框
+    */
+    void updatePageSizeBox();
+
+    /**
+    * @brief 把拖动滑块移动到当前页，正在拖动时除外
+    */
+    void updateScrubSlider();
+
+    /**
+    * @brief 拖动滑块某个位置对应的页面
+    */
+    qint64 scrubPage(int value) const;
+
+    /**
+    * @brief 在页码按钮中显示拖动滑块所在的页面，不激活任何信号
+    */
+    void previewPage(qint64 page);
+
+    /**
+    * @brief 用一次setCurrentPage切换到预览的页面，只激活一次信号
+    */
+    void finishScrub();
+
+    /**
+    * @brief 根据m_window更新页码按钮以及</>按钮，只有显示的页码变了的按钮才重新设置文字
+    */
+    void updateButtons();
+
+    /**
+    * @brief 让正好count个页码按钮可见，复用之前setCount创建的按钮
+    * @param count 显示的页码按钮数量
+    */
+    void resizeButtonPool(int count);
+
+    /**
+    * @brief 如果当前页和上次激活pageChanged时不同，用当前页激活pageChanged
+    */
+    void commitPage();
+
+    /**
+    * @brief 取消正在运行的请求，并向provider请求已提交的页面
+    */
+    void loadPage();
+
+    /**
+    * @brief 用最近的已知游标为已提交的页面激活keysetRequested
+    */
+    void requestKeyset();
+
+    /**
+    * @brief page的游标是否已知，不在键集模式中时总是true
+    */
+    bool isPageReachable(qint64 page);
+
+    /**
+    * @brief provider的future完成后触发
+    */
+    void onPageLoaded();
+
+    /**
+    * @brief 设置显示加载状态的页码按钮
+    * @param page 页号，为0时不显示
+    */
+    void setLoadingPage(qint64 page);
+
+    /**
+    * @brief 不阻塞地把页码输入框标记为错误，设置"error"属性并显示提示
+    * @param message 错误信息，为空时清除错误
+    */
+    void setInputError(const QString& message);
+
+    /**
+    * @brief 自动模式下让m_window的页码按钮数量适应宽度
+    * @return 页码按钮数量改变了返回true
+    */
+    bool fitShowCount();
+
+    /**
+    * @brief 宽度能容纳的页码按钮数量，至少为1
+    */
+    int fittedShowCount();
+
+    /**
+    * @brief 边距和除页码按钮之外的所有控件占用的宽度
+    */
+    int fixedWidth() const;
+
+    /**
+    * @brief 把页面报告给model（如果有）
+    */
+    void publishState();
+
+    /**
+    * @brief 在一批修改中应用最新发送的页面数量和页面，由上次应用之后的第一次发送排入队列
+    */
+    void applyPosted();
+
+    /**
+    * @brief 为snapshot发布按钮显示的页面
+    */
+    void updateSnapshot();
+
+    /**
+    * @brief 跟随其他pageBar或通过model本身做出的修改，不激活任何信号
+    * @param source 做出修改的pageBar，是这个pageBar本身时什么都不做
+    */
+    void onModelStateChanged(QObject* source);
+
+    /**
+    * @brief 页面总数、显示的窗口以及当前页
+    */
+    PageWindow m_window;
+
+    /**
+    * @brief pageBar中所有控件的字体
+    */
+    QFont m_font;
 
     QLabel* m_countLabel;
     QLineEdit* m_pageLineEdit;
     QPushButton* m_previousButton;
     QPushButton* m_nextButton;
     QPushButton* m_jumpButton;
+
+    /**
+    * @brief 把页码输入框限制为1~totalCount，设置了键索引时移除
+    */
+    QPageNumberValidator* m_pageValidator;
+
+    /**
+    * @brief setPageSizeOptions的下拉框，设置之前为空
+    */
+    QComboBox* m_pageSizeBox;
+
+    /**
+    * @brief setScrubSlider的滑块，隐藏时为空，以及拖动时滑块所在的页面，否则为0。
+    *        预览的页面只显示在页码按钮中，m_window仍然是拖动之前的页面
+    */
+    QSlider* m_scrubSlider;
+    qint64 m_previewPage;
+
+    /**
+    * @brief 页码按钮，只有前m_window.cellCount()个是可见的，其余的留着复用
+    */
     QVector<QPushButton*> m_pageButtons;
+
+    /**
+    * @brief 每个按钮显示的页码，省略号为0，还没有设置文字时为-1
+    */
+    QVector<qint64> m_buttonPages;
+
+    /**
+    * @brief 用于合并的定时器，前者每次切换页面都重新开始，后者在第一次未提交的切换时开始
+    */
+    QTimer* m_quietTimer;
+    QTimer* m_maxDelayTimer;
+
+    /**
+    * @brief 上次pageChanged的页码
+    */
+    qint64 m_committedPage;
+
+    QPageProvider* m_pageProvider;
+
+    /**
+    * @brief 监视正在运行的请求的future
+    */
+    QFutureWatcher<QVariant>* m_pageWatcher;
+
+    /**
+    * @brief 正在加载的页面，没有时为0
+    */
+    qint64 m_loadingPage;
+
+    /**
+    * @brief 每页的行数，没有设置时为0
+    */
+    qint64 m_pageSize;
+
+    /**
+    * @brief setRowCount的行数，页面数量是按页设置的时为-1
+    */
+    qint64 m_rowCount;
+
+    /**
+    * @brief setEstimatedCount的估计值，未知时为0。只在页面总数不确定时使用
+    */
+    qint64 m_estimatedCount;
+
+    bool m_keysetMode;
+
+    /**
+    * @brief setPageKeys报告的每一页的第一个和最后一个键
+    */
+    QHash<qint64, QPair<QVariant, QVariant>> m_pageKeys;
+
+    QPageKeyIndex* m_keyIndex;
+
+    /**
+    * @brief beginUpdate的嵌套层数，只有为0时才更新按钮
+    */
+    int m_updateDepth;
+
+    /**
+    * @brief 启用时测量延迟，否则为nullptr
+    */
+    QPageLatencyTracker* m_latencyTracker;
+
+    /**
+    * @brief 设置了trace设备时记录导航，否则为空
+    */
+    QScopedPointer<QPageTrace> m_trace;
+
+    QPageBarModel* m_model;
+
+    bool m_autoShowCount;
+
+    /**
+    * @brief 上次适应宽度时的页码按钮数量，为0时需要重新适应
+    */
+    int m_fittedShowCount;
+
+    /**
+    * @brief 没有setAutoShowCount时setCount的showCount和最小尺寸，关闭它时恢复
+    */
+    int m_manualShowCount;
+    QSize m_manualMinimumSize;
+
+    /**
+    * @brief 有m_cellDigits位数字的页码按钮的宽度加上间距，为0时需要重新测量
+    */
+    int m_cellWidth;
+    int m_cellDigits;
+
+    /**
+    * @brief postTotalCount和postCurrentPage最新的值，没有时为-1和0，以及applyPosted是否已排入队列
+    */
+    std::atomic<qint64> m_postedTotalCount;
+    std::atomic<qint64> m_postedPage;
+    std::atomic<bool> m_applyQueued;
+
+    /**
+    * @brief snapshot的页面，只在pageBar所在的线程中写入。写入期间序号为奇数
+    */
+    std::atomic<quint32> m_snapshotSequence;
+    std::atomic<qint64> m_snapshotPage;
+    std::atomic<qint64> m_snapshotCount;
+};
+
+/**
+* @brief 构造时调用QPageBar::beginUpdate，析构时调用QPageBar::endUpdate，和QSignalBlocker类似
+*/
+class QPageBarUpdateGuard
+{
+public:
+    explicit QPageBarUpdateGuard(QPageBar* pageBar) : m_pageBar(pageBar) { m_pageBar->beginUpdate(); }
+    ~QPageBarUpdateGuard() { m_pageBar->endUpdate(); }
+
+private:
+    Q_DISABLE_COPY(QPageBarUpdateGuard)
+    QPageBar* m_pageBar;
 };
 
 
@@ -0,0 +1,199 @@
+﻿#include "qpagebardelegate.h"
+
+#include <QAbstractItemView>
+#include <QApplication>
+#include <QMouseEvent>
+#include <QPainter>
+
+QPageBarDelegate::QPageBarDelegate(QObject* parent) :
+    QStyledItemDelegate(parent),
+    m_showCount(5),
+    m_elided(false),
+    m_hoveredCell(QPageBarPainter::NoCell),
+    m_pressedCell(QPageBarPainter::NoCell)
+{
+}
+
+void QPageBarDelegate::setShowCount(int showCount)
+{
+    m_showCount = showCount;
+}
+
+int QPageBarDelegate::showCount() const
+{
+    return m_showCount;
+}
+
+void QPageBarDelegate::setElided(bool elided)
+{
+    m_elided = elided;
+}
+
+bool QPageBarDelegate::isElided() const
+{
+    return m_elided;
+}
+
+PageWindow QPageBarDelegate::windowFor(const QModelIndex& index) const
+{
+    PageWindow window(index.data(PageCountRole).toLongLong(), m_showCount);
+    window.setElided(m_elided);
+    QVariant start = index.data(WindowStartRole);
+
+    // 没有保存窗口的话，放在从第1页往后翻到当前页时的位置
+    window.restore(start.isValid() ? start.toLongLong() : 1, index.data(CurrentPageRole).toLongLong());
+    return window;
+}
+
+QPageBarPainter QPageBarDelegate::painterFor(const QModelIndex& index, const QStyleOptionViewItem& option) const
+{
+    QPageBarPainter painter = m_painter;
+    painter.layout(windowFor(index), option.rect.adjusted(3, 0, -3, 0));
+    return painter;
+}
+
+void QPageBarDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    // 1. 绘制单元格的背景（包括选中状态），不绘制文字
+    QStyleOptionViewItem itemOption = option;
+    initStyleOption(&itemOption, index);
+    itemOption.text.clear();
+    const QWidget* widget = option.widget;
+    QStyle* style = widget ? widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &itemOption, painter, widget);
+
+    // 2. 绘制pageBar，页数标签使用单元格的文字颜色
+    QStyleOption barOption = option;
+    if (option.state & QStyle::State_Selected)
+        barOption.palette.setColor(QPalette::WindowText, option.palette.color(QPalette::HighlightedText));
+    else
+        barOption.palette.setColor(QPalette::WindowText, option.palette.color(QPalette::Text));
+
+    bool hovered = m_hoveredIndex == index;
+    bool pressed = m_pressedIndex == index;
+    painterFor(index, option).paint(painter, barOption, widget,
+                                    hovered ? m_hoveredCell : QPageBarPainter::NoCell,
+                                    pressed ? m_pressedCell : QPageBarPainter::NoCell);
+}
+
+QSize QPageBarDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    Q_UNUSED(option);
+    return m_painter.sizeHint(windowFor(index)) + QSize(6, 4);
+}
+
+bool QPageBarDelegate::editorEvent(QEvent* event, QAbstractItemModel* model, const QStyleOptionViewItem& option, const QModelIndex& index)
+{
+    switch (event->type())
+    {
+    case QEvent::MouseMove:
+    {
+        qint64 cell = painterFor(index, option).cellAt(static_cast<QMouseEvent*>(event)->pos());
+        if (m_hoveredIndex != index || m_hoveredCell != cell)
+        {
+            // 之前悬停的单元格失去悬停效果，鼠标离开视口时由eventFilter清除悬停
+            const QAbstractItemView* view = qobject_cast<const QAbstractItemView*>(option.widget);
+            if (m_hoveredIndex != index)
+                clearHover(view);
+            if (view)
+                view->viewport()->installEventFilter(this);
+            m_hoveredIndex = index;
+            m_hoveredCell = cell;
+            updateCell(option);
+        }
+        return false;
+    }
+
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonDblClick:
+    {
+        QMouseEvent* mouseEvent = static_cast<QMouseEvent*>(event);
+        if (mouseEvent->button() != Qt::LeftButton)
+            return false;
+
+        m_pressedIndex = index;
+        m_pressedCell = painterFor(index, option).cellAt(mouseEvent->pos());
+        updateCell(option);
+
+        // 在页码格子以外按下时仍然可以选中这一行
+        return m_pressedCell != QPageBarPainter::NoCell;
+    }
+
+    case QEvent::MouseButtonRelease:
+    {
+        QMouseEvent* mouseEvent = static_cast<QMouseEvent*>(event);
+        if (mouseEvent->button() != Qt::LeftButton || m_pressedIndex != index || m_pressedCell == QPageBarPainter::NoCell)
+            return false;
+
+        // 和QPushButton一样，只有在按下的格子上松开鼠标才算点击
+        qint64 cell = painterFor(index, option).cellAt(mouseEvent->pos());
+        qint64 pressedCell = m_pressedCell;
+        m_pressedIndex = QPersistentModelIndex();
+        m_pressedCell = QPageBarPainter::NoCell;
+        updateCell(option);
+        if (cell != pressedCell)
+            return true;
+
+        // 和QPageBar::onButtonClicked相同的窗口逻辑
+        PageWindow window = windowFor(index);
+        bool changed;
+        switch (cell)
+        {
+        case QPageBarPainter::PreviousCell:
+            changed = window.previous();
+            break;
+
+        case QPageBarPainter::NextCell:
+            changed = window.next();
+            break;
+
+        default: // 其他都是页码格子
+            changed = window.setCurrentPage(cell);
+            break;
+        }
+
+        if (changed)
+        {
+            model->setData(index, window.start(), WindowStartRole);
+            model->setData(index, window.currentPage(), CurrentPageRole);
+            emit pageChanged(index, window.currentPage());
+        }
+        return true;
+    }
+
+    default:
+        return QStyledItemDelegate::editorEvent(event, model, option, index);
+    }
+}
+
+void QPageBarDelegate::updateCell(const QStyleOptionViewItem& option) const
+{
+    const QAbstractItemView* view = qobject_cast<const QAbstractItemView*>(option.widget);
+    if (view)
+        view->viewport()->update(option.rect);
+}
+
+bool QPageBarDelegate::eventFilter(QObject* object, QEvent* event)
+{
+    // editorEvent监视的视口，其他对象都是编辑器
+    QAbstractItemView* view = qobject_cast<QAbstractItemView*>(object->parent());
+    if (view == nullptr || object != view->viewport())
+        return QStyledItemDelegate::eventFilter(object, event);
+
+    if (event->type() == QEvent::Leave || event->type() == QEvent::HoverLeave)
+        clearHover(view);
+    else if (event->type() == QEvent::MouseMove && !view->indexAt(static_cast<QMouseEvent*>(event)->pos()).isValid())
+        clearHover(view);
+    return false;
+}
+
+void QPageBarDelegate::clearHover(const QAbstractItemView* view)
+{
+    if (!m_hoveredIndex.isValid())
+        return;
+    QModelIndex index = m_hoveredIndex;
+    m_hoveredIndex = QPersistentModelIndex();
+    m_hoveredCell = QPageBarPainter::NoCell;
+    if (view)
+        view->viewport()->update(view->visualRect(index));
+}
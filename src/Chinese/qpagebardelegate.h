@@ -0,0 +1,115 @@
+﻿#ifndef QPAGEBARDELEGATE_H
+#define QPAGEBARDELEGATE_H
+
+#include <QStyledItemDelegate>
+#include <QPersistentModelIndex>
+
+#include "pagewindow.h"
+#include "qpagebarpainter.h"
+
+class QAbstractItemView;
+
+/**
+* @brief 在视图的每个单元格中绘制pageBar，不需要为每个单元格创建控件
+*        当前页和页面总数从model中读取，点击页码格子后把新的页码写回model
+*/
+class QPageBarDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+public:
+    /**
+    * @brief delegate读写的model角色
+    */
+    enum Role
+    {
+        CurrentPageRole = Qt::UserRole + 1,     // 当前页，切换页面时写回
+        PageCountRole,                          // 页面总数
+        WindowStartRole                         // 可选，显示的最左面的页码。没有的话，窗口的位置和从第1页往后翻到当前页时相同
+    };
+
+    explicit QPageBarDelegate(QObject* parent = nullptr);
+
+    /**
+    * @brief 设置每个单元格中显示的页码按钮数量
+    * @param showCount 显示的页码按钮数量
+    */
+    void setShowCount(int showCount);
+    int showCount() const;
+
+    /**
+    * @brief 每个单元格中使用省略布局"1 … 498 499 [500] 501 502 … 1000000"，见QPageBar::setElided。
+    *        此时窗口以当前页为中心，WindowStartRole会被忽略
+    * @param elided 是否使用省略布局
+    */
+    void setElided(bool elided);
+    bool isElided() const;
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+signals:
+    /**
+    * @brief 单元格中的页面切换时，激活这一信号
+    * @param index 单元格
+    * @param page 页号
+    */
+    void pageChanged(const QModelIndex& index, qint64 page);
+
+protected:
+    bool editorEvent(QEvent* event, QAbstractItemModel* model, const QStyleOptionViewItem& option, const QModelIndex& index) override;
+
+    /**
+    * @brief 鼠标离开视口或者移动到没有单元格的地方时清除悬停效果，编辑器照常处理
+    */
+    bool eventFilter(QObject* object, QEvent* event) override;
+
+private:
+    /**
+    * @brief 根据model的数据生成单元格的分页状态
+    */
+    PageWindow windowFor(const QModelIndex& index) const;
+
+    /**
+    * @brief 在option.rect中布局单元格的pageBar
+    */
+    QPageBarPainter painterFor(const QModelIndex& index, const QStyleOptionViewItem& option) const;
+
+    /**
+    * @brief 重绘发送事件的视图中的单元格
+    */
+    void updateCell(const QStyleOptionViewItem& option) const;
+
+    /**
+    * @brief 重绘有悬停效果的单元格并清除悬停
+    */
+    void clearHover(const QAbstractItemView* view);
+
+    /**
+    * @brief 每个单元格中显示的页码按钮数量
+    */
+    int m_showCount;
+
+    /**
+    * @brief 单元格是否使用省略布局
+    */
+    bool m_elided;
+
+    /**
+    * @brief 所有单元格共用的字体和间距，每个单元格重新布局
+    */
+    QPageBarPainter m_painter;
+
+    /**
+    * @brief 鼠标下的单元格以及其中的页码格子，悬停效果需要视图开启mouseTracking
+    */
+    QPersistentModelIndex m_hoveredIndex;
+    qint64 m_hoveredCell;
+
+    /**
+    * @brief 按下鼠标左键时的单元格以及其中的页码格子
+    */
+    QPersistentModelIndex m_pressedIndex;
+    qint64 m_pressedCell;
+};
+
+#endif // !QPAGEBARDELEGATE_H
@@ -0,0 +1,83 @@
+﻿#ifndef QPAGEBARMODEL_H
+#define QPAGEBARMODEL_H
+
+#include <QObject>
+
+#include "pagewindow.h"
+
+/**
+* @brief 多个pageBar共享的分页状态，比如表格上方和下方各有一个，见QPageBar::setModel。
+*        任何一个pageBar中的导航都会显示在所有pageBar上，并且model只为它激活一次pageChanged，
+*        所以后端连接到model上，而不是连接到每个pageBar上
+*/
+class QPageBarModel : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QPageBarModel(QObject* parent = nullptr);
+
+    /**
+    * @brief 共享的页面总数、窗口和当前页。每个pageBar的布局（比如省略布局或者页号按钮的数量）由pageBar自己保存
+    */
+    const PageWindow& window() const;
+
+    /**
+    * @brief QPageBar::setEstimatedCount的估计值，未知或页面总数确定时为0
+    */
+    qint64 estimatedCount() const;
+
+    qint64 currentPage() const;
+    qint64 pageCount() const;
+
+    /**
+    * @brief 通过代码设置所有pageBar的页数并回到第1页，和QPageBar::setCount一样
+    * @param totalCount 页面总数
+    * @param showCount 显示的页号按钮数
+    */
+    void setCount(qint64 totalCount, int showCount);
+
+    /**
+    * @brief 通过代码只修改所有pageBar的页面总数，和QPageBar::setTotalCount一样
+    * @param totalCount 页面总数，为0时没有页面
+    */
+    void setTotalCount(qint64 totalCount);
+
+    /**
+    * @brief 通过代码把所有pageBar切换到指定页，和QPageBar::setCurrentPage一样
+    * @param page 页号，必须在1~totalCount之间
+    */
+    void setCurrentPage(qint64 page);
+
+    /**
+    * @brief pageBar的状态变化时由它调用，其他pageBar通过stateChanged跟随
+    * @param window pageBar的状态
+    * @param estimatedCount pageBar的估计值
+    * @param source 这个pageBar，它自己不需要跟随
+    */
+    void setState(const PageWindow& window, qint64 estimatedCount, QObject* source);
+
+    /**
+    * @brief 进行导航的pageBar激活自己的pageChanged时调用，其他pageBar保持沉默
+    * @param page 页号
+    */
+    void commitPage(qint64 page);
+
+signals:
+    /**
+    * @brief 共享的状态变化时激活此信号，pageBar用它来跟随
+    * @param source 修改状态的pageBar，通过model本身修改时为nullptr
+    */
+    void stateChanged(QObject* source);
+
+    /**
+    * @brief 每次页面切换激活一次此信号，无论是在哪个pageBar中还是通过model本身切换的
+    * @param page 页号
+    */
+    void pageChanged(qint64 page);
+
+private:
+    PageWindow m_window;
+    qint64 m_estimatedCount;
+};
+
+#endif // !QPAGEBARMODEL_H
@@ -0,0 +1,114 @@
+﻿#ifndef QPAGEBARPAINTER_H
+#define QPAGEBARPAINTER_H
+
+#include <QFont>
+#include <QRect>
+#include <QString>
+
+#include "pagewindow.h"
+
+class QPainter;
+class QStyleOption;
+class QWidget;
+
+/**
+* @brief 不创建任何控件，完成pageBar中页数标签、</>按钮以及页码按钮的布局、绘制和点击判断
+*        QPaintedPageBar和QPageBarDelegate使用这个类。所有页码格子的宽度相同，所以点击判断是O(1)的
+*/
+class QPageBarPainter
+{
+public:
+    /**
+    * @brief cellAt()返回的不是页码的值，页码从1开始，所以不会和它们冲突
+    */
+    enum Cell
+    {
+        NoCell = 0,
+        PreviousCell = -1,
+        NextCell = -2
+    };
+
+    QPageBarPainter();
+
+    /**
+    * @brief 设置格子和页数标签的字体
+    */
+    void setFont(const QFont& font);
+    QFont font() const;
+
+    /**
+    * @brief 页数标签的文字，在QPageBar的上下文中翻译
+    */
+    static QString countText(const PageWindow& window);
+
+    /**
+    * @brief 显示window而不挤压格子所需的大小
+    */
+    QSize sizeHint(const PageWindow& window) const;
+
+    /**
+    * @brief 计算所有格子的位置，window或rect改变后，要先调用这个函数再调用cellAt()和paint()
+    * @param window 要显示的分页状态
+    * @param rect 布局的区域，和QPageBar一样靠右对齐
+    */
+    void layout(const PageWindow& window, const QRect& rect);
+
+    /**
+    * @brief 获取pos处的格子
+    * @return 页码格子返回页码，</>按钮可用时返回PreviousCell或NextCell，否则（包括省略号）返回NoCell
+    */
+    qint64 cellAt(const QPoint& pos) const;
+
+    /**
+    * @brief cellAt()返回的格子所在的区域，用来只重绘这个格子
+    */
+    QRect cellRect(qint64 cell) const;
+
+    /**
+    * @brief 绘制layout()布局好的pageBar
+    * @param painter 使用的painter
+    * @param option 提供格子的状态、调色板和方向
+    * @param widget 被绘制的控件，可以为nullptr
+    * @param hoveredCell 鼠标下的格子，绘制为悬停状态
+    * @param pressedCell 正在被按下的格子，绘制为按下状态
+    */
+    void paint(QPainter* painter, const QStyleOption& option, const QWidget* widget,
+               qint64 hoveredCell = NoCell, qint64 pressedCell = NoCell) const;
+
+private:
+    /**
+    * @brief 单个格子的大小，足够显示最大的页码
+    */
+    QSize cellSize(const PageWindow& window) const;
+
+    /**
+    * @brief 用style的按钮样式绘制一个格子
+    */
+    void drawCell(QPainter* painter, const QStyleOption& option, const QWidget* widget, const QRect& rect,
+                  const QString& text, bool enabled, bool checked, bool hovered, bool pressed) const;
+
+    QFont m_font;
+
+    /**
+    * @brief 两个格子之间的间距，和QPageBar中QHBoxLayout的间距相同
+    */
+    int m_spacing;
+
+    /**
+    * @brief 传给layout()的窗口
+    */
+    PageWindow m_window;
+
+    QString m_countText;
+    QRect m_countRect;
+    QRect m_previousRect;
+    QRect m_nextRect;
+
+    /**
+    * @brief 第一个页码格子的区域，第i个格子向右移动i * m_cellStride
+    */
+    QRect m_firstPageRect;
+    int m_cellStride;
+};
+
+#endif // !QPAGEBARPAINTER_H
@@ -0,0 +1,185 @@
+﻿#include "qpagecache.h"
+
+#include <QFutureInterface>
+#include <QFutureWatcher>
+
+QPageCache::QPageCache(QPageProvider* source, QObject* parent) :
+    QObject(parent),
+    m_source(source),
+    m_costFunction(&QPageCache::defaultCost),
+    m_prefetchTimer(new QTimer(this)),
+    m_prefetchCenter(0),
+    m_prefetchRadius(1),
+    m_pageCount(0),
+    m_hitCount(0),
+    m_missCount(0),
+    m_generation(0)
+{
+    // 默认16 MB
+    m_cache.setMaxCost(16 * 1024 * 1024);
+
+    m_prefetchTimer->setSingleShot(true);
+    m_prefetchTimer->setInterval(0);
+    connect(m_prefetchTimer, &QTimer::timeout, this, &QPageCache::prefetch);
+}
+
+QFuture<QVariant> QPageCache::requestPage(qint64 page)
+{
+    // 事件循环空闲时预取请求页面周围的页面
+    m_prefetchCenter = page;
+    if (m_prefetchRadius > 0)
+        m_prefetchTimer->start();
+
+    // 1. 页面已经缓存，返回已完成的future。object()同时把它标记为最近使用
+    if (QVariant* data = m_cache.object(page))
+    {
+        m_hitCount++;
+        QFutureInterface<QVariant> readyFuture;
+        readyFuture.reportStarted();
+        readyFuture.reportResult(*data);
+        readyFuture.reportFinished();
+        return readyFuture.future();
+    }
+
+    // 2. 每个请求用自己的future等待，已经在加载（比如被预取）的页面不会再次加载
+    m_missCount++;
+    if (!m_pending.contains(page))
+        fetch(page);
+    QFutureInterface<QVariant> request;
+    request.reportStarted();
+    m_pending[page].requests.append(request);
+    return request.future();
+}
+
+void QPageCache::fetch(qint64 page)
+{
+    QFuture<QVariant> future = m_source->requestPage(page);
+    m_pending.insert(page, PendingPage{ future, {} });
+
+    QFutureWatcher<QVariant>* watcher = new QFutureWatcher<QVariant>(this);
+    int generation = m_generation;
+    connect(watcher, &QFutureWatcher<QVariant>::finished, this, [this, watcher, page, generation]() {
+        QFuture<QVariant> future = watcher->future();
+        watcher->deleteLater();
+
+        // clear()之前加载的结果已经过期，clear()已经结束了它们的请求
+        if (generation != m_generation)
+            return;
+        PendingPage pending = m_pending.take(page);
+
+        bool loaded = !future.isCanceled() && future.resultCount() > 0;
+        QVariant data = loaded ? future.result() : QVariant();
+        if (loaded)
+        {
+            // 比整个预算还大的页面不会被缓存，insert会删除它
+            m_cache.insert(page, new QVariant(data), m_costFunction(data));
+        }
+
+        // 被取消的请求结束时没有结果，加载失败时所有请求都没有结果
+        for (QFutureInterface<QVariant>& request : pending.requests)
+        {
+            if (loaded && !request.isCanceled())
+                request.reportResult(data);
+            request.reportFinished();
+        }
+    });
+    watcher->setFuture(future);
+}
+
+void QPageCache::prefetch()
+{
+    // 先加载近的页面，后一页和前一页交替进行
+    for (int distance = 1; distance <= m_prefetchRadius; distance++)
+    {
+        for (qint64 page : { m_prefetchCenter + distance, m_prefetchCenter - distance })
+        {
+            if (page < 1 || (m_pageCount > 0 && page > m_pageCount))
+                continue;
+            if (m_cache.contains(page) || m_pending.contains(page))
+                continue;
+            fetch(page);
+        }
+    }
+}
+
+void QPageCache::setPrefetchRadius(int radius)
+{
+    m_prefetchRadius = radius;
+}
+
+int QPageCache::prefetchRadius() const
+{
+    return m_prefetchRadius;
+}
+
+void QPageCache::setPageCount(qint64 pageCount)
+{
+    m_pageCount = pageCount;
+}
+
+void QPageCache::setMaxCost(int bytes)
+{
+    m_cache.setMaxCost(bytes);
+}
+
+int QPageCache::maxCost() const
+{
+    return m_cache.maxCost();
+}
+
+void QPageCache::setCostFunction(const std::function<int(const QVariant&)>& costFunction)
+{
+    m_costFunction = costFunction;
+}
+
+int QPageCache::hitCount() const
+{
+    return m_hitCount;
+}
+
+int QPageCache::missCount() const
+{
+    return m_missCount;
+}
+
+void QPageCache::resetCounters()
+{
+    m_hitCount = 0;
+    m_missCount = 0;
+}
+
+void QPageCache::clear()
+{
+    for (PendingPage& pending : m_pending)
+    {
+        pending.load.cancel();
+        for (QFutureInterface<QVariant>& request : pending.requests)
+        {
+            request.cancel();
+            request.reportFinished();
+        }
+    }
+    m_pending.clear();
+    m_cache.clear();
+    m_generation++;
+}
+
+int QPageCache::defaultCost(const QVariant& data)
+{
+    switch (data.userType())
+    {
+    case QMetaType::QByteArray:
+        return int(data.toByteArray().size());
+    case QMetaType::QString:
+        return int(data.toString().size() * sizeof(QChar));
+    case QMetaType::QVariantList:
+    {
+        int cost = 0;
+        for (const QVariant& item : data.toList())
+            cost += defaultCost(item);
+        return cost;
+    }
+    default:
+        return 1;
+    }
+}
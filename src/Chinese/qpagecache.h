@@ -0,0 +1,120 @@
+﻿#ifndef QPAGECACHE_H
+#define QPAGECACHE_H
+
+#include <QObject>
+#include <QCache>
+#include <QHash>
+#include <QTimer>
+#include <QVector>
+#include <QFutureInterface>
+#include <functional>
+
+#include "qpageprovider.h"
+
+/**
+* @brief 一个QPageProvider，把另一个provider加载的页面保存在有字节预算的LRU缓存中，
+*        并且在事件循环空闲时预取请求页面的相邻页面
+*        使用时把它而不是被包装的provider传给QPageBar::setPageProvider
+*/
+class QPageCache : public QObject, public QPageProvider
+{
+    Q_OBJECT
+public:
+    /**
+    * @brief 构造函数
+    * @param source 实际加载页面的provider，缓存不负责释放
+    */
+    explicit QPageCache(QPageProvider* source, QObject* parent = nullptr);
+
+    /**
+    * @brief 从缓存中返回页面，或者从源provider加载。每个请求都有自己的future，
+    *        所以取消它只会丢弃这个请求，加载会为其他请求、预取和缓存继续进行
+    */
+    QFuture<QVariant> requestPage(qint64 page) override;
+
+    /**
+    * @brief 设置预取请求页面前后各多少页，为0时不预取
+    */
+    void setPrefetchRadius(int radius);
+    int prefetchRadius() const;
+
+    /**
+    * @brief 设置页面总数，不会预取超过它的页面。为0表示未知
+    */
+    void setPageCount(qint64 pageCount);
+
+    /**
+    * @brief 设置缓存的字节预算，超出时丢弃最久未使用的页面
+    */
+    void setMaxCost(int bytes);
+    int maxCost() const;
+
+    /**
+    * @brief 设置估算页面字节数的函数。默认计算QByteArray、QString以及它们的列表的字节数，
+    *        其他类型算作1字节
+    */
+    void setCostFunction(const std::function<int(const QVariant&)>& costFunction);
+
+    /**
+    * @brief 从缓存中返回的requestPage调用次数，以及需要等待源provider的调用次数
+    */
+    int hitCount() const;
+    int missCount() const;
+    void resetCounters();
+
+    /**
+    * @brief 丢弃所有缓存的页面，比如数据改变以后。正在运行的加载以及等待它们的请求会被取消
+    */
+    void clear();
+
+private slots:
+    /**
+    * @brief 加载上次请求页面的相邻页面中既没有缓存也没有正在加载的页面
+    */
+    void prefetch();
+
+private:
+    /**
+    * @brief 从源provider加载页面，完成后把结果放入缓存并传给等待它的请求
+    */
+    void fetch(qint64 page);
+
+    static int defaultCost(const QVariant& data);
+
+    QPageProvider* m_source;
+    QCache<qint64, QVariant> m_cache;
+
+    /**
+    * @brief 正在从源provider加载的页面，以及等待它的请求
+    */
+    struct PendingPage
+    {
+        QFuture<QVariant> load;
+        QVector<QFutureInterface<QVariant>> requests;
+    };
+    QHash<qint64, PendingPage> m_pending;
+
+    std::function<int(const QVariant&)> m_costFunction;
+
+    /**
+    * @brief 间隔为0的单次定时器，使预取在所有待处理的事件之后运行
+    */
+    QTimer* m_prefetchTimer;
+
+    /**
+    * @brief prefetch()加载这一页周围的页面
+    */
+    qint64 m_prefetchCenter;
+
+    int m_prefetchRadius;
+    qint64 m_pageCount;
+    int m_hitCount;
+    int m_missCount;
+
+    /**
+    * @brief clear()时加1，使正在运行的加载不会填充清空后的缓存
+    */
+    int m_generation;
+};
+
+#endif // !QPAGECACHE_H
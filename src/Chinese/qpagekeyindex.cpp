@@ -0,0 +1,135 @@
+﻿#include "qpagekeyindex.h"
+
+#include <QDateTime>
+
+QPageKeyIndex::QPageKeyIndex() :
+    m_lessThan(&QPageKeyIndex::defaultLessThan),
+    m_pageCount(0)
+{
+}
+
+QPageKeyIndex::QPageKeyIndex(const KeyFetcher& fetcher) : QPageKeyIndex()
+{
+    m_fetcher = fetcher;
+}
+
+void QPageKeyIndex::setKeyFetcher(const KeyFetcher& fetcher)
+{
+    m_fetcher = fetcher;
+}
+
+void QPageKeyIndex::setLessThan(const LessThan& lessThan)
+{
+    m_lessThan = lessThan;
+}
+
+void QPageKeyIndex::setPageCount(qint64 pageCount)
+{
+    m_pageCount = pageCount;
+}
+
+qint64 QPageKeyIndex::pageCount() const
+{
+    return m_pageCount;
+}
+
+void QPageKeyIndex::setBoundaryKey(qint64 page, const QVariant& firstKey)
+{
+    m_keys.insert(page, firstKey);
+}
+
+int QPageKeyIndex::size() const
+{
+    return int(m_keys.size());
+}
+
+void QPageKeyIndex::clear()
+{
+    m_keys.clear();
+}
+
+qint64 QPageKeyIndex::pageOf(const QVariant& key)
+{
+    if (m_pageCount <= 0)
+        return 0;
+
+    // 二分查找第一个键不大于key的最后一页。第1页不需要查找，
+    // 排在它的第一个键之前的键也属于第1页
+    QVariant typedKey = key;
+    qint64 low = 1;
+    qint64 high = m_pageCount;
+    while (low < high)
+    {
+        qint64 middle = low + (high - low + 1) / 2;
+        QVariant boundary = boundaryKey(middle);
+        if (!boundary.isValid())
+            return 0;
+
+        // 比较同类型的值，比如输入框的文字会被转换为数字或者日期时间
+        if (typedKey.userType() != boundary.userType())
+        {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+            bool converted = typedKey.convert(boundary.metaType());
+#else
+            bool converted = typedKey.convert(boundary.userType());
+#endif
+            if (!converted)
+                return 0;
+        }
+
+        if (m_lessThan(typedKey, boundary))
+            high = middle - 1;
+        else
+            low = middle;
+    }
+    return low;
+}
+
+QVariant QPageKeyIndex::boundaryKey(qint64 page)
+{
+    auto it = m_keys.constFind(page);
+    if (it != m_keys.constEnd())
+        return it.value();
+
+    if (!m_fetcher)
+        return QVariant();
+    QVariant key = m_fetcher(page);
+    if (key.isValid())
+        m_keys.insert(page, key);
+    return key;
+}
+
+bool QPageKeyIndex::defaultLessThan(const QVariant& left, const QVariant& right)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return QVariant::compare(left, right) == QPartialOrdering::Less;
+#else
+    // QVariant::operator<从Qt 5.15开始已弃用，所以常用的键类型按它们的值比较
+    switch (left.userType())
+    {
+    case QMetaType::Int:
+    case QMetaType::Long:
+    case QMetaType::LongLong:
+    case QMetaType::Short:
+        return left.toLongLong() < right.toLongLong();
+    case QMetaType::UInt:
+    case QMetaType::ULong:
+    case QMetaType::ULongLong:
+    case QMetaType::UShort:
+        return left.toULongLong() < right.toULongLong();
+    case QMetaType::Double:
+    case QMetaType::Float:
+        return left.toDouble() < right.toDouble();
+    case QMetaType::QDate:
+        return left.toDate() < right.toDate();
+    case QMetaType::QTime:
+        return left.toTime() < right.toTime();
+    case QMetaType::QDateTime:
+        return left.toDateTime() < right.toDateTime();
+    case QMetaType::QByteArray:
+        return left.toByteArray() < right.toByteArray();
+    default:
+        return left.toString() < right.toString();
+    }
+#endif
+}
@@ -0,0 +1,94 @@
+﻿#ifndef QPAGEKEYINDEX_H
+#define QPAGEKEYINDEX_H
+
+#include <QMap>
+#include <QVariant>
+#include <functional>
+
+/**
+* @brief 按某个键（比如客户ID或者时间戳）排序的数据的稀疏页面边界键索引。
+*        它通过对页面二分查找来找到包含某个键的页面，所以只需要获取O(log n)个页面的第一个键，
+*        获取到的键会保留下来供之后查找使用。见QPageBar::setKeyIndex
+*/
+class QPageKeyIndex
+{
+public:
+    /**
+    * @brief 返回一页第一行的键，获取不到时返回无效的QVariant。
+    *        比如SELECT key FROM table ORDER BY key LIMIT 1 OFFSET (page - 1) * pageSize
+    */
+    using KeyFetcher = std::function<QVariant(qint64 page)>;
+
+    /**
+    * @brief 返回左边的键是否排在右边的键之前
+    */
+    using LessThan = std::function<bool(const QVariant& left, const QVariant& right)>;
+
+    QPageKeyIndex();
+
+    /**
+    * @brief 构造函数
+    * @param fetcher 边界键还不在索引中时调用
+    */
+    explicit QPageKeyIndex(const KeyFetcher& fetcher);
+
+    void setKeyFetcher(const KeyFetcher& fetcher);
+
+    /**
+    * @brief 设置键的比较方式，默认比较同类型的QVariant，比如数字、字符串和日期时间
+    */
+    void setLessThan(const LessThan& lessThan);
+
+    /**
+    * @brief 设置页面总数，QPageBar::jumpToKey会让它和pageBar保持一致
+    */
+    void setPageCount(qint64 pageCount);
+    qint64 pageCount() const;
+
+    /**
+    * @brief 把已知的边界键放入索引，比如来自刚加载的页面，这样就不用再获取了
+    * @param page 页号
+    * @param firstKey 这一页第一行的键
+    */
+    void setBoundaryKey(qint64 page, const QVariant& firstKey);
+
+    /**
+    * @brief 索引中边界键的数量
+    */
+    int size() const;
+
+    /**
+    * @brief 清除所有的边界键，比如插入或删除了行之后
+    */
+    void clear();
+
+    /**
+    * @brief 查找包含key的页面，即第一个键不大于key的最后一页。
+    *        key的类型和边界键不同时会先进行转换，所以可以直接传入输入框的文字
+    * @param key 要查找的键
+    * @return 页号，key排在所有行之前时返回1，没有页面或者获取不到边界键时返回0
+    */
+    qint64 pageOf(const QVariant& key);
+
+private:
+    /**
+    * @brief page的第一个键，需要时获取并放入索引
+    */
+    QVariant boundaryKey(qint64 page);
+
+    /**
+    * @brief 比较两个类型相同的键，数字、日期/时间和字符串按值比较
+    */
+    static bool defaultLessThan(const QVariant& left, const QVariant& right);
+
+    KeyFetcher m_fetcher;
+    LessThan m_lessThan;
+    qint64 m_pageCount;
+
+    /**
+    * @brief 已知的边界键，按页号索引
+    */
+    QMap<qint64, QVariant> m_keys;
+};
+
+#endif // !QPAGEKEYINDEX_H
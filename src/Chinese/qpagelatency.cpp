@@ -0,0 +1,141 @@
+﻿#include "qpagelatency.h"
+
+#include <QtMath>
+
+// 默认禁用，这样每次导航只多一次判断
+Q_LOGGING_CATEGORY(lcPageLatency, "qpagebar.latency", QtWarningMsg)
+
+void QPageLatencyHistogram::add(qint64 nsecs)
+{
+    if (nsecs < 0)
+        nsecs = 0;
+
+    // 桶的下标是以微秒为单位的延迟的位数
+    qint64 usecs = nsecs / 1000;
+    int index = 0;
+    while (usecs > 0 && index < BucketCount - 1)
+    {
+        usecs >>= 1;
+        index++;
+    }
+
+    m_buckets[index]++;
+    m_count++;
+    m_totalNsecs += nsecs;
+    m_maxNsecs = qMax(m_maxNsecs, nsecs);
+}
+
+qint64 QPageLatencyHistogram::bucket(int index) const
+{
+    return m_buckets[index];
+}
+
+qint64 QPageLatencyHistogram::bucketLimit(int index)
+{
+    return qint64(1) << index;
+}
+
+qint64 QPageLatencyHistogram::percentile(double fraction) const
+{
+    if (m_count == 0)
+        return 0;
+
+    qint64 target = qMax<qint64>(1, qint64(qCeil(fraction * double(m_count))));
+    qint64 count = 0;
+    for (int i = 0; i < BucketCount; i++)
+    {
+        count += m_buckets[i];
+        if (count >= target)
+            return bucketLimit(i);
+    }
+    return bucketLimit(BucketCount - 1);
+}
+
+qint64 QPageLatencyHistogram::count() const
+{
+    return m_count;
+}
+
+qint64 QPageLatencyHistogram::totalNsecs() const
+{
+    return m_totalNsecs;
+}
+
+qint64 QPageLatencyHistogram::maxNsecs() const
+{
+    return m_maxNsecs;
+}
+
+void QPageLatencyHistogram::clear()
+{
+    *this = QPageLatencyHistogram();
+}
+
+QPageLatencyTracker::QPageLatencyTracker(QObject* parent) :
+    QObject(parent),
+    m_inputTime(-1),
+    m_changedTime(-1),
+    m_changedInputTime(-1),
+    m_changedPage(0),
+    m_dispatchLatency(-1)
+{
+    m_clock.start();
+}
+
+void QPageLatencyTracker::markInput()
+{
+    m_inputTime = m_clock.nsecsElapsed();
+}
+
+void QPageLatencyTracker::markChanged(qint64 page)
+{
+    // 输入现在属于这次导航。没有输入时（比如setTotalCount限制了页码），只测量之后的阶段
+    m_changedTime = m_clock.nsecsElapsed();
+    m_changedInputTime = m_inputTime;
+    m_inputTime = -1;
+    m_changedPage = page;
+    m_dispatchLatency = -1;
+    if (m_changedInputTime >= 0)
+        m_histograms[InputToChanged].add(m_changedTime - m_changedInputTime);
+}
+
+void QPageLatencyTracker::markDispatched()
+{
+    if (m_changedTime < 0)
+        return;
+    m_dispatchLatency = m_clock.nsecsElapsed() - m_changedTime;
+    m_histograms[Dispatch].add(m_dispatchLatency);
+}
+
+void QPageLatencyTracker::markReady(qint64 page)
+{
+    // 显示之前就离开了的页面，或者重复报告的页面会被忽略
+    if (m_changedPage == 0 || page != m_changedPage)
+        return;
+
+    qint64 readyTime = m_clock.nsecsElapsed();
+    m_histograms[ChangedToReady].add(readyTime - m_changedTime);
+    if (m_changedInputTime >= 0)
+        m_histograms[InputToReady].add(readyTime - m_changedInputTime);
+
+    // 未知的阶段输出为-1
+    auto msecs = [](qint64 from, qint64 to) { return from < 0 || to < 0 ? -1.0 : double(to - from) / 1e6; };
+    qCDebug(lcPageLatency, "page %lld: input to pageChanged %.3f ms, dispatch %.3f ms, pageChanged to ready %.3f ms, input to ready %.3f ms",
+            page, msecs(m_changedInputTime, m_changedTime), m_dispatchLatency < 0 ? -1.0 : double(m_dispatchLatency) / 1e6,
+            msecs(m_changedTime, readyTime), msecs(m_changedInputTime, readyTime));
+
+    m_changedPage = 0;
+    m_changedTime = -1;
+    m_changedInputTime = -1;
+}
+
+const QPageLatencyHistogram& QPageLatencyTracker::histogram(Stage stage) const
+{
+    return m_histograms[stage];
+}
+
+void QPageLatencyTracker::reset()
+{
+    for (QPageLatencyHistogram& histogram : m_histograms)
+        histogram.clear();
+}
@@ -0,0 +1,135 @@
+﻿#ifndef QPAGELATENCY_H
+#define QPAGELATENCY_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+
+/**
+* @brief 每次导航输出一行各个阶段的延迟，用规则"qpagebar.latency.debug=true"启用
+*/
+Q_DECLARE_LOGGING_CATEGORY(lcPageLatency)
+
+/**
+* @brief 以微秒为单位、桶的边界是2的幂的延迟直方图。第i个桶统计小于bucketLimit(i) = 2^i微秒、
+*        并且放不进第i - 1个桶的延迟，最后一个桶统计所有更长的延迟
+*/
+class QPageLatencyHistogram
+{
+public:
+    static constexpr int BucketCount = 32;
+
+    /**
+    * @brief 添加一个延迟
+    * @param nsecs 以纳秒为单位的延迟
+    */
+    void add(qint64 nsecs);
+
+    /**
+    * @brief 第index个桶（0 ~ BucketCount - 1）中的延迟数量
+    */
+    qint64 bucket(int index) const;
+
+    /**
+    * @brief 第index个桶的上限（不含），以微秒为单位
+    */
+    static qint64 bucketLimit(int index);
+
+    /**
+    * @brief 包含全部延迟中给定比例的桶的上限，以微秒为单位，比如p99是0.99
+    */
+    qint64 percentile(double fraction) const;
+
+    qint64 count() const;
+    qint64 totalNsecs() const;
+    qint64 maxNsecs() const;
+    void clear();
+
+private:
+    qint64 m_buckets[BucketCount] = {};
+    qint64 m_count = 0;
+    qint64 m_totalNsecs = 0;
+    qint64 m_maxNsecs = 0;
+};
+
+/**
+* @brief 记录QPageBar每次导航各个阶段的时间戳并收集它们的延迟，见QPageBar::setLatencyTracking。
+*        一次导航从输入（比如点击）开始，接着是激活pageChanged（开启合并时可能会延迟），
+*        最后使用者通过QPageBar::pageReady报告页面已经显示出来时结束
+*/
+class QPageLatencyTracker : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+    * @brief 测量的阶段
+    */
+    enum Stage
+    {
+        InputToChanged,     // 从输入到激活pageChanged，即控件本身（包括合并）
+        Dispatch,           // 连接到pageChanged的槽函数，即信号的分发
+        ChangedToReady,     // 从激活pageChanged到pageReady，即后端
+        InputToReady,       // 从输入到pageReady，即用户等待的时间
+        StageCount
+    };
+    Q_ENUM(Stage)
+
+    explicit QPageLatencyTracker(QObject* parent = nullptr);
+
+    /**
+    * @brief 记录导航输入的时间戳。pageChanged之前的新输入会替换它，因为用户现在等待的是另一页
+    */
+    void markInput();
+
+    /**
+    * @brief 记录激活pageChanged的时间戳，在激活之前调用
+    * @param page 页号
+    */
+    void markChanged(qint64 page);
+
+    /**
+    * @brief 记录pageChanged返回的时间戳，在激活之后调用
+    */
+    void markDispatched();
+
+    /**
+    * @brief 记录使用者显示page的时间戳。page不是最后一次pageChanged的页面时忽略
+    * @param page 页号
+    */
+    void markReady(qint64 page);
+
+    /**
+    * @brief 一个阶段的延迟
+    */
+    const QPageLatencyHistogram& histogram(Stage stage) const;
+
+    /**
+    * @brief 清空所有直方图
+    */
+    void reset();
+
+private:
+    QElapsedTimer m_clock;
+
+    /**
+    * @brief m_clock的纳秒时间戳，没有设置时为-1。m_inputTime是等待pageChanged的输入，
+    *        m_changedInputTime是等待markReady的导航的输入
+    */
+    qint64 m_inputTime;
+    qint64 m_changedTime;
+    qint64 m_changedInputTime;
+
+    /**
+    * @brief 最后一次pageChanged的页面，等待markReady。没有时为0
+    */
+    qint64 m_changedPage;
+
+    /**
+    * @brief 等待markReady的导航的分发延迟，和其他阶段一起输出。未知时为-1
+    */
+    qint64 m_dispatchLatency;
+
+    QPageLatencyHistogram m_histograms[StageCount];
+};
+
+#endif // !QPAGELATENCY_H
@@ -0,0 +1,50 @@
+﻿#include "qpagenumbervalidator.h"
+
+QPageNumberValidator::QPageNumberValidator(QObject* parent) :
+    QValidator(parent),
+    m_bottom(1),
+    m_top(0)
+{
+}
+
+void QPageNumberValidator::setRange(qint64 bottom, qint64 top)
+{
+    if (bottom == m_bottom && top == m_top)
+        return;
+    m_bottom = bottom;
+    m_top = top;
+    emit changed();
+}
+
+qint64 QPageNumberValidator::bottom() const
+{
+    return m_bottom;
+}
+
+qint64 QPageNumberValidator::top() const
+{
+    return m_top;
+}
+
+QValidator::State QPageNumberValidator::validate(QString& input, int& pos) const
+{
+    Q_UNUSED(pos);
+
+    // 输入可能被清空后重新输入
+    if (input.isEmpty())
+        return Intermediate;
+
+    // 只接受数字，输入时拒绝符号、空格和分隔符
+    for (QChar c : input)
+    {
+        if (c < QLatin1Char('0') || c > QLatin1Char('9'))
+            return Invalid;
+    }
+
+    // 超出qint64或超出范围的数字，再输入更多位只会更大
+    bool isOk;
+    qint64 page = input.toLongLong(&isOk);
+    if (!isOk || page > m_top)
+        return Invalid;
+    return page < m_bottom ? Intermediate : Acceptable;
+}
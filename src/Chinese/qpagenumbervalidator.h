@@ -0,0 +1,32 @@
+﻿#ifndef QPAGENUMBERVALIDATOR_H
+#define QPAGENUMBERVALIDATOR_H
+
+#include <QValidator>
+
+/**
+* @brief 接受64位范围内的页码，QIntValidator无法表示这样的范围。用于QPageBar的页码输入框，
+*        超出范围的按键会被立即拒绝，小于范围的数字只是中间状态
+*/
+class QPageNumberValidator : public QValidator
+{
+    Q_OBJECT
+public:
+    explicit QPageNumberValidator(QObject* parent = nullptr);
+
+    /**
+    * @brief 设置接受的范围，范围为空（top < bottom）时只接受空的输入
+    * @param bottom 最小的页码
+    * @param top 最大的页码
+    */
+    void setRange(qint64 bottom, qint64 top);
+    qint64 bottom() const;
+    qint64 top() const;
+
+    State validate(QString& input, int& pos) const override;
+
+private:
+    qint64 m_bottom;
+    qint64 m_top;
+};
+
+#endif // !QPAGENUMBERVALIDATOR_H
@@ -0,0 +1,25 @@
+﻿#ifndef QPAGEPROVIDER_H
+#define QPAGEPROVIDER_H
+
+#include <QFuture>
+#include <QVariant>
+
+/**
+* @brief 为QPageBar加载页面内容，见QPageBar::setPageProvider
+*        实现时在requestPage中开始加载并立即返回，比如使用QtConcurrent::run或者QFutureInterface/QPromise
+*/
+class QPageProvider
+{
+public:
+    virtual ~QPageProvider() = default;
+
+    /**
+    * @brief 开始加载页面。如果future完成前页面又切换了，future会被取消，结果也会被丢弃，
+    *        所以耗时长的实现应该检查QFuture::isCanceled并提前结束
+    * @param page 页号
+    * @return 页面内容的future
+    */
+    virtual QFuture<QVariant> requestPage(qint64 page) = 0;
+};
+
+#endif // !QPAGEPROVIDER_H
@@ -0,0 +1,313 @@
+﻿#include "qpageproxymodel.h"
+
+#include "qpagebar.h"
+
+QPageProxyModel::QPageProxyModel(QObject* parent) :
+    QAbstractProxyModel(parent),
+    m_pageSize(50),
+    m_currentPage(1),
+    m_rowCount(0),
+    m_pageCount(0),
+    m_pageCountExact(true),
+    m_pageBar(nullptr),
+    m_showCount(5)
+{
+}
+
+void QPageProxyModel::setSourceModel(QAbstractItemModel* sourceModel)
+{
+    beginResetModel();
+    for (const QMetaObject::Connection& connection : m_sourceConnections)
+        disconnect(connection);
+    m_sourceConnections.clear();
+
+    QAbstractProxyModel::setSourceModel(sourceModel);
+    m_currentPage = 1;
+    if (sourceModel != nullptr)
+    {
+        // 1. 追加到页面末尾的行（比如fetchMore获取的行）和修改的数据逐行转发
+        m_sourceConnections.append(connect(sourceModel, &QAbstractItemModel::rowsInserted, this, &QPageProxyModel::onSourceRowsInserted));
+        m_sourceConnections.append(connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, &QPageProxyModel::onSourceRowsRemoved));
+        m_sourceConnections.append(connect(sourceModel, &QAbstractItemModel::dataChanged, this, &QPageProxyModel::onSourceDataChanged));
+
+        // 2. 其他的变化都会把行移入或移出页面，所以重建页面
+        m_sourceConnections.append(connect(sourceModel, &QAbstractItemModel::modelReset, this, &QPageProxyModel::onSourceReset));
+        m_sourceConnections.append(connect(sourceModel, &QAbstractItemModel::layoutChanged, this, &QPageProxyModel::onSourceReset));
+        m_sourceConnections.append(connect(sourceModel, &QAbstractItemModel::rowsMoved, this, &QPageProxyModel::onSourceReset));
+        m_sourceConnections.append(connect(sourceModel, &QAbstractItemModel::columnsInserted, this, &QPageProxyModel::onSourceReset));
+        m_sourceConnections.append(connect(sourceModel, &QAbstractItemModel::columnsRemoved, this, &QPageProxyModel::onSourceReset));
+        m_sourceConnections.append(connect(sourceModel, &QAbstractItemModel::columnsMoved, this, &QPageProxyModel::onSourceReset));
+    }
+    m_rowCount = pageRowCount();
+    endResetModel();
+
+    // 新的源模型从第1页开始，pageBar也一样
+    if (m_pageBar != nullptr)
+        m_pageBar->setCurrentPage(1);
+    m_pageCount = -1;
+    updatePageCount();
+}
+
+void QPageProxyModel::setPageSize(int pageSize)
+{
+    if (pageSize <= 0 || pageSize == m_pageSize)
+        return;
+
+    // 页面的第一行保持可见
+    qint64 firstRow = offset();
+    m_pageSize = pageSize;
+    m_currentPage = firstRow / m_pageSize + 1;
+    resetPage();
+
+    // 新的页面总数和新的页码在一批中交给pageBar，这样中间不会限制旧的页码
+    if (m_pageBar != nullptr)
+        m_pageBar->beginUpdate();
+    m_pageCount = -1;
+    updatePageCount();
+    if (m_pageBar != nullptr)
+    {
+        m_pageBar->setPageSize(m_pageSize);
+        m_pageBar->setCurrentPage(m_currentPage);
+        m_pageBar->endUpdate();
+    }
+}
+
+int QPageProxyModel::pageSize() const
+{
+    return m_pageSize;
+}
+
+void QPageProxyModel::setCurrentPage(qint64 page)
+{
+    if (page < 1 || page == m_currentPage || (m_pageCountExact && page > m_pageCount))
+        return;
+
+    m_currentPage = page;
+    resetPage();
+
+    // pageBar会激活pageChanged，它带着当前页回到这里，然后被忽略
+    if (m_pageBar != nullptr && m_pageBar->currentPage() != page)
+        m_pageBar->setCurrentPage(page);
+}
+
+qint64 QPageProxyModel::currentPage() const
+{
+    return m_currentPage;
+}
+
+qint64 QPageProxyModel::pageCount() const
+{
+    return m_pageCount;
+}
+
+bool QPageProxyModel::isPageCountExact() const
+{
+    return m_pageCountExact;
+}
+
+void QPageProxyModel::setPageBar(QPageBar* pageBar, int showCount)
+{
+    if (m_pageBar != nullptr)
+        disconnect(m_pageBar, nullptr, this, nullptr);
+    m_pageBar = pageBar;
+    m_showCount = showCount;
+    if (m_pageBar == nullptr)
+        return;
+
+    // 1. pageBar从源模型的页面开始，位于模型的当前页
+    m_pageBar->setPageSize(m_pageSize);
+    if (m_pageCountExact)
+        m_pageBar->setCount(m_pageCount, m_showCount);
+    else
+        m_pageBar->setEstimatedCount(m_pageCount, m_showCount);
+    if (m_currentPage != 1)
+        m_pageBar->setCurrentPage(m_currentPage);
+
+    // 2. 之后由pageBar切换页面，有每页行数下拉框时也由它切换每页行数
+    connect(m_pageBar, &QPageBar::pageChanged, this, &QPageProxyModel::setCurrentPage);
+    connect(m_pageBar, &QPageBar::pageSizeChanged, this, [this](qint64 pageSize) { setPageSize(int(pageSize)); });
+    connect(m_pageBar, &QObject::destroyed, this, [this]() { m_pageBar = nullptr; });
+}
+
+QModelIndex QPageProxyModel::index(int row, int column, const QModelIndex& parent) const
+{
+    if (parent.isValid() || row < 0 || row >= m_rowCount || column < 0 || column >= columnCount())
+        return QModelIndex();
+    return createIndex(row, column);
+}
+
+QModelIndex QPageProxyModel::parent(const QModelIndex& child) const
+{
+    Q_UNUSED(child);
+    return QModelIndex();
+}
+
+int QPageProxyModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_rowCount;
+}
+
+int QPageProxyModel::columnCount(const QModelIndex& parent) const
+{
+    if (parent.isValid() || sourceModel() == nullptr)
+        return 0;
+    return sourceModel()->columnCount();
+}
+
+QModelIndex QPageProxyModel::mapToSource(const QModelIndex& proxyIndex) const
+{
+    if (!proxyIndex.isValid() || sourceModel() == nullptr)
+        return QModelIndex();
+    return sourceModel()->index(int(offset() + proxyIndex.row()), proxyIndex.column());
+}
+
+QModelIndex QPageProxyModel::mapFromSource(const QModelIndex& sourceIndex) const
+{
+    if (!sourceIndex.isValid() || sourceIndex.parent().isValid())
+        return QModelIndex();
+    qint64 row = sourceIndex.row() - offset();
+    if (row < 0 || row >= m_rowCount)
+        return QModelIndex();
+    return index(int(row), sourceIndex.column());
+}
+
+bool QPageProxyModel::canFetchMore(const QModelIndex& parent) const
+{
+    if (parent.isValid() || sourceModel() == nullptr)
+        return false;
+    return sourceModel()->rowCount() < offset() + m_pageSize && sourceModel()->canFetchMore(QModelIndex());
+}
+
+void QPageProxyModel::fetchMore(const QModelIndex& parent)
+{
+    if (parent.isValid() || sourceModel() == nullptr)
+        return;
+
+    // 源模型按自己的批次获取，新的行通过rowsInserted到达。
+    // 异步获取的源模型不会立即增长，这时视图稍后会再次询问
+    while (canFetchMore(parent))
+    {
+        int rowCount = sourceModel()->rowCount();
+        sourceModel()->fetchMore(QModelIndex());
+        if (sourceModel()->rowCount() == rowCount)
+            break;
+    }
+}
+
+qint64 QPageProxyModel::offset() const
+{
+    return (m_currentPage - 1) * m_pageSize;
+}
+
+int QPageProxyModel::pageRowCount() const
+{
+    if (sourceModel() == nullptr)
+        return 0;
+    qint64 rows = sourceModel()->rowCount() - offset();
+    return int(qBound<qint64>(0, rows, m_pageSize));
+}
+
+void QPageProxyModel::resetPage()
+{
+    beginResetModel();
+    m_rowCount = pageRowCount();
+    endResetModel();
+}
+
+void QPageProxyModel::updatePageCount()
+{
+    qint64 rows = sourceModel() != nullptr ? sourceModel()->rowCount() : 0;
+    bool exact = sourceModel() == nullptr || !sourceModel()->canFetchMore(QModelIndex());
+    qint64 pageCount = (rows + m_pageSize - 1) / m_pageSize;
+    if (pageCount == m_pageCount && exact == m_pageCountExact)
+        return;
+    m_pageCount = pageCount;
+    m_pageCountExact = exact;
+
+    // 页面总数确定后，最后一页之后的当前页会移到最后一页，和QPageBar::setTotalCount一样
+    if (m_pageCountExact && m_currentPage > qMax<qint64>(m_pageCount, 1))
+    {
+        m_currentPage = qMax<qint64>(m_pageCount, 1);
+        resetPage();
+    }
+    emit pageCountChanged(m_pageCount);
+    updatePageBar();
+}
+
+void QPageProxyModel::updatePageBar()
+{
+    if (m_pageBar == nullptr)
+        return;
+
+    // 确定的页面总数结束pageBar的估计模式，源模型又能获取更多行时（比如重置之后）重新开始估计模式
+    if (m_pageCountExact)
+    {
+        m_pageBar->setTotalCount(m_pageCount);
+    }
+    else if (m_pageBar->isCountExact())
+    {
+        m_pageBar->setEstimatedCount(m_pageCount, m_showCount);
+        if (m_currentPage != 1)
+            m_pageBar->setCurrentPage(m_currentPage);
+    }
+    else
+    {
+        m_pageBar->setEstimate(m_pageCount);
+    }
+}
+
+void QPageProxyModel::onSourceRowsInserted(const QModelIndex& parent, int first, int last)
+{
+    Q_UNUSED(last);
+    if (parent.isValid())
+        return;
+
+    // 页面之后的行不会改变页面，紧接在页面已获取的行之后追加的行会扩展页面，
+    // 插入到页面之前或页面中的行会让页面移动
+    if (first < offset() + m_pageSize)
+    {
+        int rowCount = pageRowCount();
+        if (first == offset() + m_rowCount && rowCount > m_rowCount)
+        {
+            beginInsertRows(QModelIndex(), m_rowCount, rowCount - 1);
+            m_rowCount = rowCount;
+            endInsertRows();
+        }
+        else
+        {
+            resetPage();
+        }
+    }
+    updatePageCount();
+}
+
+void QPageProxyModel::onSourceRowsRemoved(const QModelIndex& parent, int first, int last)
+{
+    Q_UNUSED(last);
+    if (parent.isValid())
+        return;
+
+    // 删除页面之前或页面中的行会让页面移动
+    if (first < offset() + m_rowCount)
+        resetPage();
+    updatePageCount();
+}
+
+void QPageProxyModel::onSourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles)
+{
+    if (topLeft.parent().isValid() || m_rowCount == 0)
+        return;
+
+    // 只转发范围中位于页面上的部分
+    qint64 top = qMax<qint64>(topLeft.row(), offset());
+    qint64 bottom = qMin<qint64>(bottomRight.row(), offset() + m_rowCount - 1);
+    if (top > bottom)
+        return;
+    emit dataChanged(index(int(top - offset()), topLeft.column()), index(int(bottom - offset()), bottomRight.column()), roles);
+}
+
+void QPageProxyModel::onSourceReset()
+{
+    resetPage();
+    updatePageCount();
+}
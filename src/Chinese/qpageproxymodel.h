@@ -0,0 +1,127 @@
+﻿#ifndef QPAGEPROXYMODEL_H
+#define QPAGEPROXYMODEL_H
+
+#include <QAbstractProxyModel>
+#include <QVector>
+
+class QPageBar;
+
+/**
+* @brief 在任意视图中只显示平面源模型（比如表格或列表）当前页的行。
+*        用setPageBar绑定QPageBar后，由pageBar切换页面，并显示源模型的页数。
+*        通过canFetchMore/fetchMore只获取到当前页末尾为止的行，所以对于QSqlQueryModel这样延迟加载的源模型，
+*        视图最多只接触一页的数据。源模型还能获取更多行时，页面总数是估计值
+*/
+class QPageProxyModel : public QAbstractProxyModel
+{
+    Q_OBJECT
+public:
+    explicit QPageProxyModel(QObject* parent = nullptr);
+
+    void setSourceModel(QAbstractItemModel* sourceModel) override;
+
+    /**
+    * @brief 设置每页的行数。包含当前页第一行的页面成为当前页
+    * @param pageSize 每页的行数，必须大于0
+    */
+    void setPageSize(int pageSize);
+    int pageSize() const;
+
+    /**
+    * @brief 切换到指定页，视图中的行会被替换。绑定的pageBar也会切换
+    * @param page 页号，在1~pageCount之间，页面总数是估计值时也可以是之后的任意页
+    */
+    void setCurrentPage(qint64 page);
+    qint64 currentPage() const;
+
+    /**
+    * @brief 目前从源模型获取到的行的页数
+    */
+    qint64 pageCount() const;
+
+    /**
+    * @brief 源模型是否已经没有更多的行可以获取，也就是pageCount是确定的
+    */
+    bool isPageCountExact() const;
+
+    /**
+    * @brief 绑定pageBar：它的页数跟随源模型，它的页面切换会切换这个模型。
+    *        页数用setCount设置，源模型还能获取更多行时用setEstimatedCount设置
+    * @param pageBar pageBar，不归模型所有。nullptr解除绑定
+    * @param showCount 显示的页码按钮数
+    */
+    void setPageBar(QPageBar* pageBar, int showCount = 5);
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex mapToSource(const QModelIndex& proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex& sourceIndex) const override;
+
+    /**
+    * @brief 源模型是否还能获取更多行，并且还没有获取到当前页的所有行
+    */
+    bool canFetchMore(const QModelIndex& parent) const override;
+
+    /**
+    * @brief 从源模型获取行，直到当前页完整或者源模型没有更多的行
+    */
+    void fetchMore(const QModelIndex& parent) override;
+
+signals:
+    /**
+    * @brief 页数或者页数是否确定发生变化时激活此信号
+    * @param pageCount 页数
+    */
+    void pageCountChanged(qint64 pageCount);
+
+private:
+    /**
+    * @brief 当前页第一行在源模型中的行号
+    */
+    qint64 offset() const;
+
+    /**
+    * @brief 源模型已经获取到的当前页的行数
+    */
+    int pageRowCount() const;
+
+    /**
+    * @brief 重建当前页的行，用于所有无法对应到单独的行的源模型变化
+    */
+    void resetPage();
+
+    /**
+    * @brief 源模型变化后重新计算页数，并报告给pageBar
+    */
+    void updatePageCount();
+
+    /**
+    * @brief 把页数报告给pageBar
+    */
+    void updatePageBar();
+
+    void onSourceRowsInserted(const QModelIndex& parent, int first, int last);
+    void onSourceRowsRemoved(const QModelIndex& parent, int first, int last);
+    void onSourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles);
+    void onSourceReset();
+
+    int m_pageSize;
+    qint64 m_currentPage;
+
+    /**
+    * @brief 显示的行数，只在变化通知的开始和结束之间修改
+    */
+    int m_rowCount;
+
+    qint64 m_pageCount;
+    bool m_pageCountExact;
+
+    QPageBar* m_pageBar;
+    int m_showCount;
+
+    QVector<QMetaObject::Connection> m_sourceConnections;
+};
+
+#endif // !QPAGEPROXYMODEL_H
@@ -0,0 +1,80 @@
+﻿#include "qpagetrace.h"
+
+#include <QIODevice>
+
+// "QPBT"和格式版本
+static const quint32 TraceMagic = 0x51504254;
+static const quint16 TraceVersion = 2;
+
+QPageTrace::QPageTrace(QIODevice* device) :
+    m_stream(device),
+    m_lastUsecs(0)
+{
+    // 固定流的版本，这样trace可以在Qt 5和Qt 6之间交换
+    m_stream.setVersion(QDataStream::Qt_5_0);
+    m_stream << TraceMagic << TraceVersion;
+    m_clock.start();
+}
+
+void QPageTrace::record(Kind kind, qint64 value, qint32 showCount)
+{
+    writeEvent(kind, value);
+    if (kind == Count || kind == EstimatedCount || kind == RowCount)
+        m_stream << showCount;
+}
+
+void QPageTrace::recordModelState(const PageWindow& window, qint64 estimatedCount)
+{
+    writeEvent(ModelState, estimatedCount);
+    m_stream << window.totalCount() << qint32(window.showCount()) << window.start() << window.currentPage() << quint8(window.isOpenEnded());
+}
+
+void QPageTrace::writeEvent(Kind kind, qint64 value)
+{
+    // 32位的间隔可以表示两个事件之间一个多小时，更长的停顿会被缩短
+    qint64 usecs = m_clock.nsecsElapsed() / 1000;
+    quint32 delta = quint32(qMin<qint64>(usecs - m_lastUsecs, 0xFFFFFFFF));
+    m_lastUsecs = usecs;
+
+    m_stream << quint8(kind) << delta << value;
+}
+
+bool QPageTrace::readHeader(QDataStream& stream)
+{
+    quint32 magic = 0;
+    quint16 version = 0;
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream >> magic >> version;
+    // 版本1只是缺少Jump之后的类型，所以用同样的方式读取
+    return stream.status() == QDataStream::Ok && magic == TraceMagic && version >= 1 && version <= TraceVersion;
+}
+
+bool QPageTrace::readEvent(QDataStream& stream, Event* event)
+{
+    quint8 kind = 0;
+    quint32 delta = 0;
+    stream >> kind >> delta >> event->value;
+    if (stream.status() != QDataStream::Ok || kind < Count || kind > ModelState)
+        return false;
+
+    event->kind = Kind(kind);
+    event->usecs += delta;
+    event->showCount = 0;
+    event->window = PageWindow();
+    if (event->kind == Count || event->kind == EstimatedCount || event->kind == RowCount)
+    {
+        stream >> event->showCount;
+    }
+    else if (event->kind == ModelState)
+    {
+        qint64 totalCount = 0;
+        qint64 start = 0;
+        qint64 page = 0;
+        quint8 openEnded = 0;
+        stream >> totalCount >> event->showCount >> start >> page >> openEnded;
+        event->window.setCount(totalCount, event->showCount);
+        event->window.setOpenEnded(openEnded != 0);
+        event->window.restore(start, page);
+    }
+    return stream.status() == QDataStream::Ok;
+}
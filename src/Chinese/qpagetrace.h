@@ -0,0 +1,96 @@
+﻿#ifndef QPAGETRACE_H
+#define QPAGETRACE_H
+
+#include <QDataStream>
+#include <QElapsedTimer>
+
+#include "pagewindow.h"
+
+class QIODevice;
+
+/**
+* @brief QPageBar导航的紧凑二进制trace，见QPageBar::setTraceDevice。
+*        trace以头部开始，之后每次导航一个事件：类型（1字节）、距上一个事件的微秒数（4字节）
+*        以及页码或页面总数（8字节），Count、EstimatedCount和RowCount事件还有显示的按钮数（4字节），
+*        ModelState事件还有采用的页面（29字节）。
+*        trace由tools/QPageBarReplay重放。版本1的trace只包含Jump及之前的类型
+*/
+class QPageTrace
+{
+public:
+    enum Kind : quint8
+    {
+        Count = 1,          // setCount，value为页面总数，showCount为页号按钮数
+        TotalCount,         // setTotalCount，value为页面总数
+        Previous,           // <按钮
+        Next,               // >按钮
+        Page,               // 页号按钮，value为页码
+        Jump,               // 跳转按钮或jumpToKey，value为页码
+        EstimatedCount,     // setEstimatedCount，value为估计值，showCount为页号按钮数
+        Estimate,           // setEstimate，value为估计值
+        RowCount,           // setRowCount，value为行数，showCount为页号按钮数
+        PageSize,           // setPageSize，value为每页的行数
+        Elided,             // setElided，value为1或0
+        KeysetMode,         // setKeysetMode，value为1或0
+        ModelState          // 从QPageBarModel采用的页面，value为估计值，window为页面
+    };
+
+    struct Event
+    {
+        Kind kind;
+        qint64 usecs;       // 距trace开始的微秒数
+        qint64 value;
+        qint32 showCount;
+        PageWindow window;  // 只用于ModelState
+    };
+
+    /**
+    * @brief 开始一个trace，头部会立即写入
+    * @param device 写入的设备，必须已打开，并且在记录期间保持有效
+    */
+    explicit QPageTrace(QIODevice* device);
+
+    /**
+    * @brief 追加一个事件
+    * @param kind 事件类型
+    * @param value 页码或页面总数，Previous和Next为0
+    * @param showCount 页号按钮数，只有Count、EstimatedCount和RowCount会写入
+    */
+    void record(Kind kind, qint64 value = 0, qint32 showCount = 0);
+
+    /**
+    * @brief 追加一个ModelState事件
+    * @param window 模型的页面：页面总数、显示的按钮数、窗口、当前页以及页面总数是否不确定
+    * @param estimatedCount 模型的估计值
+    */
+    void recordModelState(const PageWindow& window, qint64 estimatedCount);
+
+    /**
+    * @brief 读取并检查trace的头部
+    * @return 如果流中不是支持的版本的trace，返回false，支持版本1和2
+    */
+    static bool readHeader(QDataStream& stream);
+
+    /**
+    * @brief 读取下一个事件
+    * @param event 读到的事件，它的usecs在原有的值上累加，所以整个trace要传入同一个event
+    * @return 到达trace末尾或事件损坏时返回false
+    */
+    static bool readEvent(QDataStream& stream, Event* event);
+
+private:
+    /**
+    * @brief 写入类型、距上一个事件的时间和value
+    */
+    void writeEvent(Kind kind, qint64 value);
+
+    QDataStream m_stream;
+    QElapsedTimer m_clock;
+
+    /**
+    * @brief 上一个事件的时间，m_clock的微秒数
+    */
+    qint64 m_lastUsecs;
+};
+
+#endif // !QPAGETRACE_H
@@ -0,0 +1,123 @@
+﻿#ifndef QPAINTEDPAGEBAR_H
+#define QPAINTEDPAGEBAR_H
+
+#include <QWidget>
+
+#include "pagewindow.h"
+#include "qpagebarpainter.h"
+
+/**
+* @brief 轻量的QPageBar，自己绘制页数标签、</>按钮和页码按钮，而不是使用子控件
+*        适合同时显示很多pageBar的场景，没有页码输入框
+*/
+class QPaintedPageBar : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit QPaintedPageBar(QWidget* parent = nullptr);
+
+    /**
+    * @brief 构造函数
+    * @param pageTotalCount 全部的页面数量
+    * @param pageShowCount 显示的页码按钮数量
+    */
+    explicit QPaintedPageBar(qint64 pageTotalCount, int pageShowCount = 5, QWidget* parent = nullptr);
+
+    /**
+    * @brief 设置页面的数量。showCount不会超过totalCount，setTotalCount增加页面总数时会恢复
+    * @param totalCount 全部的页面数量
+    * @param showCount 显示的页码按钮数量
+    */
+    void setCount(qint64 totalCount, int showCount);
+
+    /**
+    * @brief 只修改页面总数并保留当前页，见QPageBar::setTotalCount
+    * @param totalCount 全部的页面数量，0表示没有页面
+    */
+    void setTotalCount(qint64 totalCount);
+
+    /**
+    * @brief 清空页面按钮和数量
+    */
+    void clear();
+
+    /**
+    * @brief 获取当前页面号
+    * @return 当前页号
+    */
+    qint64 currentPage();
+
+    /**
+    * @brief 在代码中切换到指定的页面，比如恢复视图时。和点击一样激活pageChanged
+    * @param page 页号，必须在1~totalCount之内
+    */
+    void setCurrentPage(qint64 page);
+
+    /**
+    * @brief 获取页面数量
+    * @return 页面数量
+    */
+    qint64 pageCount();
+
+    /**
+    * @brief 切换到省略布局"1 … 498 499 [500] 501 502 … 1000000"，见QPageBar::setElided
+    * @param elided 是否使用省略布局
+    */
+    void setElided(bool elided);
+    bool isElided();
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+signals:
+    /**
+    * @brief 当页面切换时，激活这一信号
+    * @param page 页号
+    */
+    void pageChanged(qint64 page);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void changeEvent(QEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void leaveEvent(QEvent* event) override;
+
+private:
+    /**
+    * @brief 切换到指定的页面并重绘
+    * @param page 页号
+    */
+    void moveToPage(qint64 page);
+
+    /**
+    * @brief 窗口、大小或字体改变后重新计算格子的位置
+    */
+    void relayout();
+
+    /**
+    * @brief 设置鼠标下的格子，并重绘悬停状态改变了的格子
+    */
+    void setHoveredCell(qint64 cell);
+
+    /**
+    * @brief 页面总数、显示的窗口以及当前页
+    */
+    PageWindow m_window;
+
+    QPageBarPainter m_painter;
+
+    /**
+    * @brief 鼠标下的格子，见QPageBarPainter::cellAt
+    */
+    qint64 m_hoveredCell;
+
+    /**
+    * @brief 按下鼠标左键时的格子，在同一个格子上松开才算点击
+    */
+    qint64 m_pressedCell;
+};
+
+#endif // !QPAINTEDPAGEBAR_H
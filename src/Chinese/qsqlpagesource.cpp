@@ -0,0 +1,256 @@
+﻿#include "qsqlpagesource.h"
+
+#include <QFutureInterface>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QSqlRecord>
+
+#include "qpagebar.h"
+
+QSqlPageSource::QSqlPageSource(const QString& driver, const QString& databaseName, QObject* parent) :
+    QObject(parent),
+    m_worker(new QObject),
+    m_connectionName(QStringLiteral("QSqlPageSource-%1").arg(quintptr(this), 0, 16)),
+    m_driver(driver),
+    m_databaseName(databaseName),
+    m_pageSize(50),
+    m_pageBar(nullptr),
+    m_showCount(5),
+    m_rowCount(-1),
+    m_generation(0)
+{
+    m_worker->moveToThread(&m_thread);
+    m_thread.setObjectName(m_connectionName);
+    m_thread.start();
+}
+
+QSqlPageSource::~QSqlPageSource()
+{
+    // 连接必须在打开它的线程中、在排队的查询之后关闭
+    QString connectionName = m_connectionName;
+    QMetaObject::invokeMethod(m_worker, [connectionName]() {
+        if (QSqlDatabase::contains(connectionName))
+        {
+            QSqlDatabase::database(connectionName, false).close();
+            QSqlDatabase::removeDatabase(connectionName);
+        }
+    }, Qt::BlockingQueuedConnection);
+    m_thread.quit();
+    m_thread.wait();
+    delete m_worker;
+}
+
+void QSqlPageSource::setConnectionSetup(const std::function<void(QSqlDatabase&)>& setup)
+{
+    m_setup = setup;
+}
+
+void QSqlPageSource::setQuery(const QString& selectSql, const QString& countSql, const QVariantMap& bindValues)
+{
+    m_selectSql = selectSql;
+    m_countSql = countSql;
+    m_bindValues = bindValues;
+    m_rowCount = -1;
+    m_generation++;
+}
+
+void QSqlPageSource::setPageSize(int pageSize)
+{
+    if (pageSize > 0)
+        m_pageSize = pageSize;
+}
+
+int QSqlPageSource::pageSize() const
+{
+    return m_pageSize;
+}
+
+void QSqlPageSource::setPageBar(QPageBar* pageBar, int showCount)
+{
+    if (m_pageBar != nullptr)
+    {
+        m_pageBar->setPageProvider(nullptr);
+        disconnect(m_pageBar, nullptr, this, nullptr);
+    }
+    m_pageBar = pageBar;
+    m_showCount = showCount;
+    if (m_pageBar == nullptr)
+        return;
+
+    m_pageBar->setPageSize(m_pageSize);
+    m_pageBar->setPageProvider(this);
+    connect(m_pageBar, &QPageBar::pageSizeChanged, this, &QSqlPageSource::followPageSize);
+    connect(m_pageBar, &QObject::destroyed, this, [this]() { m_pageBar = nullptr; });
+}
+
+void QSqlPageSource::refresh()
+{
+    // 第1页立即显示，计数查询排在它之后。之前的查询的结果已经过时
+    m_rowCount = -1;
+    m_generation++;
+    if (m_pageBar != nullptr)
+    {
+        m_pageBar->setPageSize(m_pageSize);
+        m_pageBar->setEstimatedCount(0, m_showCount);
+        m_pageBar->reload();
+    }
+    if (!m_countSql.isEmpty())
+        count();
+}
+
+QFuture<QVariant> QSqlPageSource::requestPage(qint64 page)
+{
+    QFutureInterface<QVariant> result;
+    result.reportStarted();
+
+    // 1. 查询使用设置的副本执行，LIMIT和OFFSET是数字，所以直接追加到SQL中
+    QString connectionName = m_connectionName;
+    QString driver = m_driver;
+    QString databaseName = m_databaseName;
+    std::function<void(QSqlDatabase&)> setup = m_setup;
+    QString sql = m_selectSql + QStringLiteral(" LIMIT %1 OFFSET %2").arg(m_pageSize).arg((page - 1) * m_pageSize);
+    QVariantMap bindValues = m_bindValues;
+    int pageSize = m_pageSize;
+    bool findEnd = m_countSql.isEmpty();
+    quint32 generation = m_generation;
+
+    QMetaObject::invokeMethod(m_worker, [=]() mutable {
+        // 2. 查询开始前就已离开的页面会被跳过，refresh之前的查询也一样
+        if (result.isCanceled() || generation != m_generation)
+        {
+            result.reportFinished();
+            return;
+        }
+
+        QSqlDatabase db = database(connectionName, driver, databaseName, setup);
+        QSqlQuery query(db);
+        query.prepare(sql);
+        for (auto it = bindValues.constBegin(); it != bindValues.constEnd(); ++it)
+            query.bindValue(it.key(), it.value());
+        if (!query.exec())
+        {
+            // 没有结果的future会像失败的请求一样被QPageBar丢弃
+            QString message = query.lastError().text();
+            result.reportFinished();
+            QMetaObject::invokeMethod(this, [this, message]() { emit errorOccurred(message); }, Qt::QueuedConnection);
+            return;
+        }
+
+        // 3. 这一页的所有行在这里收集，然后作为一批数据传到GUI线程
+        QVariantList rows;
+        int columnCount = query.record().count();
+        while (query.next())
+        {
+            QVariantList row;
+            row.reserve(columnCount);
+            for (int i = 0; i < columnCount; i++)
+                row.append(query.value(i));
+            rows.append(QVariant(row));
+        }
+
+        // 查询执行期间的refresh使它的行过时，future没有结果就结束
+        if (generation != m_generation)
+        {
+            result.reportFinished();
+            return;
+        }
+        result.reportResult(QVariant(rows));
+        result.reportFinished();
+
+        // 4. 没有计数查询时，行数不足的一页就是最后一页
+        if (findEnd && rows.size() < pageSize)
+        {
+            qint64 rowCount = (page - 1) * pageSize + rows.size();
+            QMetaObject::invokeMethod(this, [this, rowCount, generation]() { setRowCount(rowCount, generation); }, Qt::QueuedConnection);
+        }
+    }, Qt::QueuedConnection);
+
+    return result.future();
+}
+
+void QSqlPageSource::count()
+{
+    QString connectionName = m_connectionName;
+    QString driver = m_driver;
+    QString databaseName = m_databaseName;
+    std::function<void(QSqlDatabase&)> setup = m_setup;
+    QString sql = m_countSql;
+    QVariantMap bindValues = m_bindValues;
+    quint32 generation = m_generation;
+
+    QMetaObject::invokeMethod(m_worker, [=]() {
+        if (generation != m_generation)
+            return;
+
+        QSqlDatabase db = database(connectionName, driver, databaseName, setup);
+        QSqlQuery query(db);
+        query.prepare(sql);
+        for (auto it = bindValues.constBegin(); it != bindValues.constEnd(); ++it)
+            query.bindValue(it.key(), it.value());
+        if (!query.exec() || !query.next())
+        {
+            QString message = query.lastError().text();
+            QMetaObject::invokeMethod(this, [this, message]() { emit errorOccurred(message); }, Qt::QueuedConnection);
+            return;
+        }
+
+        qint64 rowCount = query.value(0).toLongLong();
+        QMetaObject::invokeMethod(this, [this, rowCount, generation]() { setRowCount(rowCount, generation); }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+}
+
+void QSqlPageSource::setRowCount(qint64 rowCount, quint32 generation)
+{
+    // refresh之后才完成的查询统计的是旧的行
+    if (generation != m_generation)
+        return;
+
+    // 总数结束refresh的估计模式，当前页会被保留，除非它已不存在
+    m_rowCount = rowCount;
+    emit rowCountChanged(rowCount);
+    if (m_pageBar != nullptr)
+        m_pageBar->setTotalCount(qMax<qint64>((rowCount + m_pageSize - 1) / m_pageSize, 1));
+}
+
+void QSqlPageSource::followPageSize(qint64 pageSize)
+{
+    // 1. 这个source自己设置的每页行数会回到这里，忽略它
+    if (pageSize <= 0 || pageSize == m_pageSize)
+        return;
+    qint64 firstRow = (m_pageBar->currentPage() - 1) * m_pageSize;
+    m_pageSize = int(pageSize);
+
+    // 2. 不知道行数时页面是未知的，pageBar像refresh之后一样从第1页重新开始
+    if (m_rowCount < 0)
+    {
+        m_pageBar->setEstimatedCount(0, m_showCount);
+        m_pageBar->reload();
+        return;
+    }
+
+    // 3. 新的总数和第一行所在的页面在一批修改中到达pageBar，即使页号不变也会重新加载这一页
+    qint64 page = firstRow / m_pageSize + 1;
+    bool samePage = page == m_pageBar->currentPage();
+    m_pageBar->beginUpdate();
+    m_pageBar->setTotalCount(qMax<qint64>((m_rowCount + m_pageSize - 1) / m_pageSize, 1));
+    m_pageBar->setCurrentPage(page);
+    m_pageBar->endUpdate();
+    if (samePage)
+        m_pageBar->reload();
+}
+
+QSqlDatabase QSqlPageSource::database(const QString& connectionName, const QString& driver, const QString& databaseName,
+                                      const std::function<void(QSqlDatabase&)>& setup)
+{
+    // QSqlDatabase只能在创建它的线程中使用，所以连接在第一次使用时在这里创建
+    if (QSqlDatabase::contains(connectionName))
+        return QSqlDatabase::database(connectionName);
+
+    QSqlDatabase db = QSqlDatabase::addDatabase(driver, connectionName);
+    db.setDatabaseName(databaseName);
+    if (setup)
+        setup(db);
+    db.open();
+    return db;
+}
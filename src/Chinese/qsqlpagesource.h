@@ -0,0 +1,143 @@
+﻿#ifndef QSQLPAGESOURCE_H
+#define QSQLPAGESOURCE_H
+
+#include <QObject>
+#include <QThread>
+#include <QVariantMap>
+#include <atomic>
+#include <functional>
+
+#include "qpageprovider.h"
+
+class QPageBar;
+class QSqlDatabase;
+
+/**
+* @brief 一个QPageProvider，在工作线程中用自己的数据库连接执行LIMIT/OFFSET查询，慢查询不会阻塞GUI线程。
+*        每一页作为一批数据到达，是行的QVariantList，每一行是各列的QVariantList。
+*        可选的计数查询在第一页之后于后台执行，并把总数报告给pageBar。
+*        需要QT += sql
+*/
+class QSqlPageSource : public QObject, public QPageProvider
+{
+    Q_OBJECT
+public:
+    /**
+    * @brief 构造函数，连接由第一次查询在工作线程中打开
+    * @param driver Qt SQL驱动，例如"QSQLITE"或"QPSQL"
+    * @param databaseName 数据库名，SQLite时是数据库文件的路径
+    */
+    QSqlPageSource(const QString& driver, const QString& databaseName, QObject* parent = nullptr);
+    ~QSqlPageSource() override;
+
+    /**
+    * @brief 设置在打开连接之前配置连接的函数，例如主机名、用户名和密码。
+    *        它在工作线程中被调用
+    */
+    void setConnectionSetup(const std::function<void(QSqlDatabase&)>& setup);
+
+    /**
+    * @brief 设置查询，之后的请求使用它们
+    * @param selectSql 不带LIMIT/OFFSET的行查询，每一页会追加它们，例如"SELECT * FROM log ORDER BY id"
+    * @param countSql 行数的查询，例如"SELECT COUNT(*) FROM log"。计数太慢时为空，
+    *        此时某一页返回的行数不足时即找到末尾
+    * @param bindValues 两个查询的命名占位符的值，例如{":level", 3}
+    */
+    void setQuery(const QString& selectSql, const QString& countSql = QString(), const QVariantMap& bindValues = QVariantMap());
+
+    /**
+    * @brief 设置每页的行数
+    * @param pageSize 每页的行数，必须大于0
+    */
+    void setPageSize(int pageSize);
+    int pageSize() const;
+
+    /**
+    * @brief 为pageBar加载页面：它获得这个source作为provider以及每页行数，refresh会更新它的页数。
+    *        在pageBar中选择的每页行数，比如在它的每页行数下拉框中，会成为source的每页行数
+    * @param pageBar pageBar，source不负责释放。为nullptr时解除绑定
+    * @param showCount 显示的页码按钮数量
+    */
+    void setPageBar(QPageBar* pageBar, int showCount = 5);
+
+    /**
+    * @brief 重新执行查询，例如setQuery之后或数据改变之后。pageBar以未知的总数回到第1页并加载它，
+    *        然后计数查询在后台执行。之前排队的查询会被跳过，仍在执行的查询的结果会被丢弃
+    */
+    void refresh();
+
+    /**
+    * @brief 把一页的查询排入工作线程。在执行前被取消的请求会被跳过
+    */
+    QFuture<QVariant> requestPage(qint64 page) override;
+
+signals:
+    /**
+    * @brief 得知行数时激活这一信号，来自计数查询或行数不足的一页
+    * @param rowCount 行数
+    */
+    void rowCountChanged(qint64 rowCount);
+
+    /**
+    * @brief 连接无法打开或查询失败时激活这一信号
+    * @param message 驱动的错误信息
+    */
+    void errorOccurred(const QString& message);
+
+private:
+    /**
+    * @brief 把计数查询排入工作线程
+    */
+    void count();
+
+    /**
+    * @brief 在GUI线程中把行数报告给pageBar
+    * @param generation 查询的代数，旧的代数的行数会被丢弃
+    */
+    void setRowCount(qint64 rowCount, quint32 generation);
+
+    /**
+    * @brief 跟随在pageBar中选择的每页行数。显示的第一行所在的页面成为当前页，并重新加载
+    */
+    void followPageSize(qint64 pageSize);
+
+    /**
+    * @brief 工作线程的连接，第一次使用时打开。只能在工作线程中调用
+    */
+    static QSqlDatabase database(const QString& connectionName, const QString& driver, const QString& databaseName,
+                                 const std::function<void(QSqlDatabase&)>& setup);
+
+    QThread m_thread;
+
+    /**
+    * @brief 位于工作线程，查询被排入它的事件队列
+    */
+    QObject* m_worker;
+
+    /**
+    * @brief 设置会被复制到每个查询中，工作线程从不读取它们
+    */
+    QString m_connectionName;
+    QString m_driver;
+    QString m_databaseName;
+    std::function<void(QSqlDatabase&)> m_setup;
+    QString m_selectSql;
+    QString m_countSql;
+    QVariantMap m_bindValues;
+    int m_pageSize;
+
+    QPageBar* m_pageBar;
+    int m_showCount;
+
+    /**
+    * @brief 查询的行数，得到计数之前为-1
+    */
+    qint64 m_rowCount;
+
+    /**
+    * @brief setQuery和refresh时加一。每个查询带有排队时的代数，工作线程跳过旧的查询，GUI线程丢弃它们的行数
+    */
+    std::atomic<quint32> m_generation;
+};
+
+#endif // !QSQLPAGESOURCE_H
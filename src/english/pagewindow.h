@@ -0,0 +1,357 @@
+#ifndef PAGEWINDOW_H
+#define PAGEWINDOW_H
+
+#include <QtGlobal>
+
+/**
+* @brief The paging state behind QPageBar: total pages, the visible window of page buttons and the current page.
+*        It only needs qint64 from QtCore and allocates nothing, so it can be used (and tested) without a QApplication.
+*        Every operation is O(1); pages are numbered from 1 and are 64-bit, the number of page buttons is an int.
+*/
+class PageWindow
+{
+public:
+    constexpr PageWindow() noexcept = default;
+
+    /**
+    * @brief Constructor
+    * @param totalCount Total number of pages
+    * @param showCount Number of page buttons to show
+    */
+    constexpr PageWindow(qint64 totalCount, int showCount) noexcept
+    {
+        setCount(totalCount, showCount);
+    }
+
+    /**
+    * @brief Set the number of pages and go back to page 1. showCount is clamped to totalCount,
+    *        so setCount(0, showCount) starts an empty window that setTotalCount grows up to showCount buttons
+    * @param totalCount Total number of pages
+    * @param showCount Number of page buttons to show
+    */
+    constexpr void setCount(qint64 totalCount, int showCount) noexcept
+    {
+        if (showCount > 0)
+            m_maxShowCount = showCount;
+        if (totalCount <= 0 || showCount <= 0)
+        {
+            clear();
+            return;
+        }
+        m_totalCount = totalCount;
+        m_showCount = showCount < totalCount ? showCount : int(totalCount);
+        m_currentPage = 1;
+        m_start = m_elided ? elidedStart() : 1;
+    }
+
+    /**
+    * @brief Change the number of pages, keeping the current page and the window. Both are only clamped if the total has shrunk below them,
+    *        and showCount shrinks with the total and grows back up to the showCount of setCount
+    * @param totalCount Total number of pages, 0 for none
+    * @return true if the current page has changed
+    */
+    constexpr bool setTotalCount(qint64 totalCount) noexcept
+    {
+        qint64 oldPage = m_currentPage;
+        m_totalCount = totalCount > 0 ? totalCount : 0;
+        m_showCount = m_maxShowCount < m_totalCount ? m_maxShowCount : int(m_totalCount);
+        if (isEmpty())
+        {
+            m_start = 1;
+            m_currentPage = 1;
+        }
+        else
+        {
+            restore(m_start, m_currentPage);
+        }
+        return m_currentPage != oldPage;
+    }
+
+    /**
+    * @brief Change the number of page buttons, keeping the current page, which stays visible. showCount is clamped to totalCount
+    * @param showCount Number of page buttons to show
+    */
+    constexpr void setShowCount(int showCount) noexcept
+    {
+        if (showCount <= 0)
+            return;
+        m_maxShowCount = showCount;
+        m_showCount = showCount < m_totalCount ? showCount : int(m_totalCount);
+        restore(m_start, m_currentPage);
+    }
+
+    /**
+    * @brief Switch between the contiguous layout, where the page buttons show showCount consecutive pages,
+    *        and the elided layout "1 … 498 499 [500] 501 502 … 1000000", where showCount pages around the current page are shown
+    *        together with the first and the last page. The elided layout uses at most showCount + 4 cells for any total
+    * @param elided Whether to use the elided layout
+    */
+    constexpr void setElided(bool elided) noexcept
+    {
+        m_elided = elided;
+        if (m_elided)
+            m_start = elidedStart();
+        else
+            restore(m_start, m_currentPage);
+    }
+
+    constexpr bool isElided() const noexcept { return m_elided; }
+
+    /**
+    * @brief Mark the total as open-ended, i.e. only an estimate or a lower bound of the real number of pages.
+    *        The > button then stays enabled on the last page, and next() adds a page to the total
+    * @param openEnded Whether more pages than totalCount may exist
+    */
+    constexpr void setOpenEnded(bool openEnded) noexcept { m_openEnded = openEnded; }
+    constexpr bool isOpenEnded() const noexcept { return m_openEnded; }
+
+    /**
+    * @brief Reset to an empty window without pages, the layout and the showCount of setCount are kept
+    */
+    constexpr void clear() noexcept
+    {
+        m_totalCount = 0;
+        m_showCount = 0;
+        m_start = 1;
+        m_currentPage = 1;
+    }
+
+    /**
+    * @brief Switch to the given page, shifting the window as little as possible so that the page is visible
+    * @param page The page number, must be within 1~totalCount
+    * @return true if the current page has changed
+    */
+    constexpr bool setCurrentPage(qint64 page) noexcept
+    {
+        if (!contains(page) || page == m_currentPage)
+            return false;
+
+        // In the elided layout the window is centered on the current page
+        if (m_elided)
+        {
+            m_currentPage = page;
+            m_start = elidedStart();
+            return true;
+        }
+
+        // If the page is smaller than the minimum displayed page number, it becomes the first button
+        if (page < m_start)
+            m_start = page;
+        // If the page is larger than the maximum displayed page number, it becomes the last button
+        else if (page > end())
+            m_start = page - m_showCount + 1;
+        m_currentPage = page;
+        return true;
+    }
+
+    /**
+    * @brief Restore a window saved from start() and currentPage(). Both are clamped, so the current page is always visible
+    * @param start The leftmost page number shown
+    * @param currentPage The currently selected page number
+    */
+    constexpr void restore(qint64 start, qint64 currentPage) noexcept
+    {
+        if (isEmpty())
+            return;
+
+        m_currentPage = currentPage < 1 ? 1 : (currentPage > m_totalCount ? m_totalCount : currentPage);
+        if (m_elided)
+        {
+            m_start = elidedStart();
+            return;
+        }
+        qint64 minStart = m_currentPage - m_showCount + 1 < 1 ? 1 : m_currentPage - m_showCount + 1;
+        qint64 maxStart = m_currentPage < m_totalCount - m_showCount + 1 ? m_currentPage : m_totalCount - m_showCount + 1;
+        m_start = start < minStart ? minStart : (start > maxStart ? maxStart : start);
+    }
+
+    /**
+    * @brief Switch to the previous page (the < button)
+    * @return true if the current page has changed
+    */
+    constexpr bool previous() noexcept
+    {
+        return setCurrentPage(m_currentPage - 1);
+    }
+
+    /**
+    * @brief Switch to the next page (the > button)
+    * @return true if the current page has changed
+    */
+    constexpr bool next() noexcept
+    {
+        // Past the end of an open-ended total the next page is assumed to exist
+        if (m_openEnded && !isEmpty() && m_currentPage == m_totalCount)
+            setTotalCount(m_totalCount + 1);
+        return setCurrentPage(m_currentPage + 1);
+    }
+
+    constexpr qint64 totalCount() const noexcept { return m_totalCount; }
+    constexpr int showCount() const noexcept { return m_showCount; }
+    constexpr qint64 currentPage() const noexcept { return m_currentPage; }
+
+    /**
+    * @brief The showCount of setCount or setShowCount, which showCount grows back up to when the total grows
+    */
+    constexpr int maxShowCount() const noexcept { return m_maxShowCount; }
+
+    /**
+    * @brief The leftmost (and smallest) page number shown in the widget. In the elided layout, of the pages around the current page
+    */
+    constexpr qint64 start() const noexcept { return m_start; }
+
+    /**
+    * @brief The rightmost (and largest) page number shown in the widget. In the elided layout, of the pages around the current page
+    */
+    constexpr qint64 end() const noexcept { return m_start + m_showCount - 1; }
+
+    constexpr bool isEmpty() const noexcept { return m_totalCount == 0; }
+
+    /**
+    * @brief Whether page is a valid page number
+    */
+    constexpr bool contains(qint64 page) const noexcept { return page >= 1 && page <= m_totalCount; }
+
+    /**
+    * @brief Whether page is shown by one of the page buttons
+    */
+    constexpr bool isVisible(qint64 page) const noexcept { return !isEmpty() && page >= m_start && page <= end(); }
+
+    /**
+    * @brief The page number shown by the page button at index (0 ~ showCount - 1)
+    */
+    constexpr qint64 pageAt(int index) const noexcept { return m_start + index; }
+
+    /**
+    * @brief The index of the page button showing page, or -1 if it is not visible
+    */
+    constexpr int indexOf(qint64 page) const noexcept { return isVisible(page) ? int(page - m_start) : -1; }
+
+    /**
+    * @brief Whether the page button at index is the checked one
+    */
+    constexpr bool isCurrent(int index) const noexcept { return pageAt(index) == m_currentPage; }
+
+    /**
+    * @brief Whether the elided layout actually elides pages, i.e. not all pages fit into showCount + 4 cells
+    */
+    constexpr bool hasEllipses() const noexcept { return m_elided && m_totalCount > m_showCount + 4; }
+
+    /**
+    * @brief Number of cells (page buttons and ellipses) the layout needs. The same as showCount in the contiguous layout
+    */
+    constexpr int cellCount() const noexcept
+    {
+        if (!m_elided)
+            return m_showCount;
+        return hasEllipses() ? m_showCount + 4 : int(m_totalCount);
+    }
+
+    /**
+    * @brief The page number shown by the cell at index (0 ~ cellCount - 1)
+    * @return The page number, or 0 if the cell is an ellipsis
+    */
+    constexpr qint64 cellPage(int index) const noexcept
+    {
+        if (!m_elided)
+            return pageAt(index);
+        if (!hasEllipses())
+            return index + 1;
+
+        // The cells are: 1, 2 or …, the pages around the current page, totalCount - 1 or …, totalCount
+        if (index == 0)
+            return 1;
+        if (index == cellCount() - 1)
+            return m_totalCount;
+        if (index == 1)
+            return m_start == 3 ? 2 : 0;
+        if (index == cellCount() - 2)
+            return end() == m_totalCount - 2 ? m_totalCount - 1 : 0;
+        return m_start + index - 2;
+    }
+
+    /**
+    * @brief The index of the cell showing page, or -1 if it is not visible
+    */
+    constexpr int cellOf(qint64 page) const noexcept
+    {
+        if (!m_elided)
+            return indexOf(page);
+        if (!contains(page))
+            return -1;
+        if (!hasEllipses())
+            return int(page - 1);
+
+        if (page == 1)
+            return 0;
+        if (page == m_totalCount)
+            return cellCount() - 1;
+        if (page >= m_start && page <= end())
+            return int(page - m_start) + 2;
+        if (page == 2 && m_start == 3)
+            return 1;
+        if (page == m_totalCount - 1 && end() == m_totalCount - 2)
+            return cellCount() - 2;
+        return -1;
+    }
+
+    /**
+    * @brief Enabled state of the < button
+    */
+    constexpr bool canGoPrevious() const noexcept { return !isEmpty() && m_currentPage > 1; }
+
+    /**
+    * @brief Enabled state of the > button
+    */
+    constexpr bool canGoNext() const noexcept { return m_currentPage < m_totalCount || (m_openEnded && !isEmpty()); }
+
+private:
+    /**
+    * @brief The start of the elided layout: the current page is centered, but the window stays between the first two and the last two cells
+    */
+    constexpr qint64 elidedStart() const noexcept
+    {
+        if (!hasEllipses())
+            return 1;
+        qint64 start = m_currentPage - m_showCount / 2;
+        qint64 maxStart = m_totalCount - m_showCount - 1;
+        return start < 3 ? 3 : (start > maxStart ? maxStart : start);
+    }
+
+    /**
+    * @brief Total number of pages
+    */
+    qint64 m_totalCount = 0;
+
+    /**
+    * @brief Number of pages to show in the page bar
+    */
+    int m_showCount = 0;
+
+    /**
+    * @brief The showCount passed to setCount, m_showCount grows back up to it when the total grows
+    */
+    int m_maxShowCount = 0;
+
+    /**
+    * @brief The leftmost (and smallest) page number shown in the widget
+    */
+    qint64 m_start = 1;
+
+    /**
+    * @brief The currently selected page number
+    */
+    qint64 m_currentPage = 1;
+
+    /**
+    * @brief Whether the elided layout is used
+    */
+    bool m_elided = false;
+
+    /**
+    * @brief Whether m_totalCount is only an estimate or a lower bound
+    */
+    bool m_openEnded = false;
+};
+
+#endif // !PAGEWINDOW_H
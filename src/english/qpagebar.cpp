@@ -2,17 +2,43 @@
 
 #include <QLabel>
 #include <QPushButton>
+#include <QComboBox>
 #include <QHBoxLayout>
-#include <QMessageBox>
+#include <QToolTip>
+#include <QStyleOptionButton>
+#include <QStyle>
+#include <QLocale>
+#include <QKeyEvent>
 #include <QDebug>
 
+// The most steps of the scrub slider, more pages are scaled down to them
+static const int ScrubSteps = 100000;
+
 QPageBar::QPageBar(QWidget* parent) :
     QWidget(parent),
-    m_pageTotalCount(0),
-    m_pageShowCount(0),
     m_countLabel(new QLabel(tr("Total pages: ") + QString::number(0), this)),
     m_pageLineEdit(new QLineEdit(this)),
-    m_jumpButton(new QPushButton(tr("Ok"), this))
+    m_jumpButton(new QPushButton(tr("Ok"), this)),
+    m_pageSizeBox(nullptr),
+    m_scrubSlider(nullptr),
+    m_previewPage(0),
+    m_estimatedCount(0),
+    m_keysetMode(false),
+    m_keyIndex(nullptr),
+    m_updateDepth(0),
+    m_latencyTracker(nullptr),
+    m_model(nullptr),
+    m_autoShowCount(false),
+    m_fittedShowCount(0),
+    m_manualShowCount(0),
+    m_cellWidth(0),
+    m_cellDigits(0),
+    m_postedTotalCount(-1),
+    m_postedPage(0),
+    m_applyQueued(false),
+    m_snapshotSequence(0),
+    m_snapshotPage(1),
+    m_snapshotCount(0)
 {
     // 1. Initialize the layout and various widgets. If you need to adjust the size or font of the widgets, modify this part of the code.
     // 1.1 Set horizontal layout
@@ -21,26 +47,25 @@ QPageBar::QPageBar(QWidget* parent) :
 
     // 1.2 Initialize the previous page button
     m_previousButton = new QPushButton(tr("<"), this);
-    m_previousButton->setWhatsThis("-1"); // Record which button the current button belongs to through WhatsThis to facilitate logic processing after button click
     m_previousButton->setEnabled(false);
 
     // 1.3 Initialize the next page button
     m_nextButton = new QPushButton(">");
-    m_nextButton->setWhatsThis("-2"); // Record which button the current button belongs to through WhatsThis to facilitate logic processing after button click
     QLabel* label1 = new QLabel(tr("Go to page No."), this);
 
-    // 1.4 Set the size of the page number input box
+    // 1.4 Set the size of the page number input box, which only accepts existing pages
     m_pageLineEdit->setMaximumWidth(75);
+    m_pageValidator = new QPageNumberValidator(this);
+    m_pageLineEdit->setValidator(m_pageValidator);
 
-    // 1.5 Set the font
-    QFont font;
-    font.setPointSize(10);
-    m_countLabel->setFont(font);
-    m_pageLineEdit->setFont(font);
-    label1->setFont(font);
-    m_previousButton->setFont(font);
-    m_nextButton->setFont(font);
-    m_jumpButton->setFont(font);
+    // 1.5 Set the font, all buttons share this font
+    m_font.setPointSize(10);
+    m_countLabel->setFont(m_font);
+    m_pageLineEdit->setFont(m_font);
+    label1->setFont(m_font);
+    m_previousButton->setFont(m_font);
+    m_nextButton->setFont(m_font);
+    m_jumpButton->setFont(m_font);
 
     // 2. Add widgets to the layout
     hBoxLayout->addStretch();
@@ -59,95 +84,291 @@ QPageBar::QPageBar(QWidget* parent) :
     connect(m_nextButton, &QPushButton::clicked, this, &QPageBar::onButtonClicked);
     // 3.3 Logic of the jump button
     connect(m_jumpButton, &QPushButton::clicked, this, [&]() {
-        bool isOk;
-        int page = m_pageLineEdit->text().toInt(&isOk);
-        if (!isOk || page < 1 || page > m_pageTotalCount)
+        // With a key index the input is a key, e.g. a customer ID or a timestamp
+        if (m_keyIndex != nullptr)
         {
-            QMessageBox errMsgBox(QMessageBox::Critical, tr("Page number error"),
-                                  tr("Please enter the correct page number, range 1~%1").arg(m_pageTotalCount));
-            errMsgBox.exec();
+            if (jumpToKey(m_pageLineEdit->text()) == 0)
+                setInputError(tr("No page can be found for %1").arg(m_pageLineEdit->text()));
+            return;
         }
+
+        bool isOk;
+        qint64 page = m_pageLineEdit->text().toLongLong(&isOk);
+        if (!isOk || !m_window.contains(page))
+            setInputError(tr("Please enter the correct page number, range 1~%1").arg(m_window.totalCount()));
+        else if (!isPageReachable(page))
+            setInputError(tr("Only visited pages and their neighbours can be opened"));
         else
         {
-            if (m_currentPage == page)
-                return;
-
-            // If the page to be jumped to is already displayed, switch directly
-            if (m_pageStart <= page && m_pageStart + m_pageShowCount - 1 >= page)
-            {
-                m_pageButtons[m_currentPage - m_pageStart]->setChecked(false);
-                m_pageButtons[page - m_pageStart]->setChecked(true);
-            }
-            // If not displayed, case 1: the page to be jumped to is smaller than the minimum displayed page number
-            else if (m_pageStart > page)
-            {
-                for (int i = 0; i < m_pageShowCount; i++)
-                {
-                    m_pageButtons[i]->setWhatsThis(QString::number(page + i));
-                    m_pageButtons[i]->setText(QString::number(page + i));
-                    m_pageButtons[i]->setChecked(false);
-                }
-                m_pageButtons[0]->setChecked(true);
-                m_pageStart = page;
-            }
-            // Case 2: the page to be jumped to is larger than the maximum displayed page number
-            else
-            {
-                for (int i = 0; i < m_pageShowCount; i++)
-                {
-                    m_pageButtons[i]->setWhatsThis(QString::number(page - m_pageShowCount + i + 1));
-                    m_pageButtons[i]->setText(QString::number(page - m_pageShowCount + i + 1));
-                    m_pageButtons[i]->setChecked(false);
-                }
-                m_pageButtons[m_pageShowCount - 1]->setChecked(true);
-                m_pageStart = page - m_pageShowCount + 1;
-            }
-            m_currentPage = page;
-            emit pageChanged(page);
+            if (!m_trace.isNull())
+                m_trace->record(QPageTrace::Jump, page);
+            setInputError(QString());
+            moveToPage(page);
         }
     });
+    // 3.4 Enter in the page number input box jumps like the jump button, see eventFilter, typing clears the error
+    m_pageLineEdit->installEventFilter(this);
+    connect(m_pageLineEdit, &QLineEdit::textEdited, this, [&]() { setInputError(QString()); });
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    // Keystrokes that lead out of the range are rejected by the validator, the error tells why
+    connect(m_pageLineEdit, &QLineEdit::inputRejected, this, [&]() {
+        if (m_keyIndex == nullptr)
+            setInputError(tr("Please enter the correct page number, range 1~%1").arg(m_window.totalCount()));
+    });
+#endif
+
+    // 4. Timers for coalescing pageChanged, see setCoalescing
+    m_committedPage = 1;
+    m_quietTimer = new QTimer(this);
+    m_quietTimer->setSingleShot(true);
+    m_maxDelayTimer = new QTimer(this);
+    m_maxDelayTimer->setSingleShot(true);
+    connect(m_quietTimer, &QTimer::timeout, this, &QPageBar::commitPage);
+    connect(m_maxDelayTimer, &QTimer::timeout, this, &QPageBar::commitPage);
+
+    // 5. Loading pages from the provider, see setPageProvider
+    m_pageProvider = nullptr;
+    m_loadingPage = 0;
+    m_pageSize = 0;
+    m_rowCount = -1;
+    m_pageWatcher = new QFutureWatcher<QVariant>(this);
+    connect(m_pageWatcher, &QFutureWatcher<QVariant>::finished, this, &QPageBar::onPageLoaded);
 }
 
-QPageBar::QPageBar(int pageTotalCount, int pageShowCount, QWidget* parent) : QPageBar(parent)
+QPageBar::QPageBar(qint64 pageTotalCount, int pageShowCount, QWidget* parent) : QPageBar(parent)
 {
     setCount(pageTotalCount, pageShowCount);
     if (pageTotalCount > 0)
         m_pageButtons[0]->setChecked(true);
 }
 
-void QPageBar::setCount(int totalCount, int showCount)
+void QPageBar::setCount(qint64 totalCount, int showCount)
+{
+    if (showCount <= 0) // if there is no page button to show
+    {
+        qDebug() << "showCount必须大于0"; // showCount must be greater than 0
+        return;
+    }
+
+    if (!m_trace.isNull())
+        m_trace->record(QPageTrace::Count, totalCount, showCount);
+    m_window.setOpenEnded(false);
+    m_rowCount = -1;
+    resetCount(totalCount, showCount);
+}
+
+void QPageBar::setRowCount(qint64 rowCount, int showCount)
+{
+    if (m_pageSize <= 0)
+    {
+        qDebug() << "setRowCount之前必须设置pageSize"; // the page size must be set before setRowCount
+        return;
+    }
+
+    // The last page may be partial, fewer pages than page buttons are fine here
+    qint64 totalCount = (qMax<qint64>(rowCount, 0) + m_pageSize - 1) / m_pageSize;
+    if (!m_trace.isNull())
+        m_trace->record(QPageTrace::RowCount, rowCount, showCount);
+    m_window.setOpenEnded(false);
+    m_rowCount = qMax<qint64>(rowCount, 0);
+    resetCount(totalCount, showCount);
+}
+
+qint64 QPageBar::rowCount()
+{
+    return m_rowCount;
+}
+
+void QPageBar::setEstimatedCount(qint64 estimate, int showCount)
+{
+    // Without an estimate only page 1 is known to exist
+    if (!m_trace.isNull())
+        m_trace->record(QPageTrace::EstimatedCount, estimate, showCount);
+    m_estimatedCount = estimate > 0 ? estimate : 0;
+    m_window.setOpenEnded(true);
+    m_rowCount = -1;
+    resetCount(qMax<qint64>(m_estimatedCount, 1), showCount);
+}
+
+void QPageBar::resetCount(qint64 totalCount, int showCount)
+{
+    // 1. Initialize the paging state, a pending pageChanged is dropped
+    m_window.setCount(totalCount, showCount);
+    if (m_autoShowCount)
+    {
+        m_manualShowCount = m_window.maxShowCount();
+        m_fittedShowCount = 0;
+        fitShowCount();
+    }
+    m_pageKeys.clear();
+    m_quietTimer->stop();
+    m_maxDelayTimer->stop();
+    m_committedPage = m_window.currentPage();
+
+    updateCountLabel();
+
+    // 2. Reuse the existing page number buttons, only the difference is created or hidden
+    resizeButtonPool(m_window.cellCount());
+    updateButtons();
+    publishState();
+}
+
+void QPageBar::setTotalCount(qint64 totalCount)
+{
+    if (!m_trace.isNull())
+        m_trace->record(QPageTrace::TotalCount, totalCount);
+    m_window.setOpenEnded(false);
+    m_rowCount = -1;
+    updateTotalCount(totalCount);
+}
+
+void QPageBar::setEstimate(qint64 estimate)
+{
+    if (!m_window.isOpenEnded())
+        return;
+    if (!m_trace.isNull())
+        m_trace->record(QPageTrace::Estimate, estimate);
+
+    // The pages up to the current one are known to exist, even if the new estimate is smaller
+    m_estimatedCount = estimate > 0 ? estimate : 0;
+    updateTotalCount(qMax(m_estimatedCount, m_window.currentPage()));
+}
+
+bool QPageBar::isCountExact()
+{
+    return !m_window.isOpenEnded();
+}
+
+void QPageBar::updateTotalCount(qint64 totalCount)
 {
-    if (totalCount < showCount) // if the total count is smaller than the show count
+    // 1. Only the total changes, the current page is clamped if the pages after it are gone
+    int cellCount = m_window.cellCount();
+    bool changed = m_window.setTotalCount(totalCount);
+    if (m_autoShowCount)
+        fitShowCount();
+    updateCountLabel();
+
+    // 2. The pool is only touched if the number of cells changed, otherwise just the buttons whose page changed are relabeled
+    if (m_window.cellCount() != cellCount)
+        resizeButtonPool(m_window.cellCount());
+    updateButtons();
+    publishState();
+
+    if (changed && m_updateDepth == 0)
     {
-        qDebug() << "totalCount必须大于或等于showCount"; // totalCount must be greater than or equal to showCount
+        emit pageRequested(m_window.currentPage());
+        commitPage();
+    }
+}
+
+void QPageBar::updateCountLabel()
+{
+    // Inside beginUpdate/endUpdate, endUpdate updates everything once
+    if (m_updateDepth > 0)
+        return;
+
+    // The known pages can be entered, with an estimate also the ones reached with the > button so far
+    m_pageValidator->setRange(1, m_window.totalCount());
+    if (m_window.isOpenEnded() && m_estimatedCount > 0)
+        m_countLabel->setText(tr("Total pages: ~%1").arg(QLocale().toString(qMax(m_estimatedCount, m_window.totalCount()))));
+    else if (m_window.isOpenEnded())
+        m_countLabel->setText(tr("Page %1 of many").arg(m_previewPage != 0 ? m_previewPage : m_window.currentPage()));
+    else
+        m_countLabel->setText(tr("Total pages: ") + QString::number(m_window.totalCount())); // set the count label text to show the total number of pages
+}
+
+void QPageBar::updatePageSizeBox()
+{
+    // A page size that is not among the options shows no selection
+    if (m_pageSizeBox != nullptr)
+        m_pageSizeBox->setCurrentIndex(m_pageSizeBox->findData(m_pageSize));
+}
+
+void QPageBar::updateScrubSlider()
+{
+    if (m_scrubSlider == nullptr || m_scrubSlider->isSliderDown())
+        return;
+
+    // Up to ScrubSteps pages map to one step each, the value is set without activating valueChanged
+    QSignalBlocker blocker(m_scrubSlider);
+    qint64 last = qMax<qint64>(m_window.totalCount() - 1, 0);
+    int maximum = int(qMin<qint64>(last, ScrubSteps));
+    m_scrubSlider->setRange(0, maximum);
+    m_scrubSlider->setPageStep(qMax(maximum / 20, 1));
+    if (maximum == last)
+        m_scrubSlider->setValue(int(m_window.currentPage() - 1));
+    else
+        m_scrubSlider->setValue(qRound(double(m_window.currentPage() - 1) / last * maximum));
+    m_scrubSlider->setEnabled(last > 0 && !m_keysetMode);
+}
+
+qint64 QPageBar::scrubPage(int value) const
+{
+    qint64 last = m_window.totalCount() - 1;
+    int maximum = m_scrubSlider->maximum();
+    if (maximum == 0 || maximum == last)
+        return value + 1;
+    return 1 + qRound64(double(value) / maximum * last);
+}
+
+void QPageBar::previewPage(qint64 page)
+{
+    // Only the page buttons follow the handle, and the count label of "Page n of many". The pages stay untouched
+    if (page == m_previewPage || !m_window.contains(page))
         return;
+    m_previewPage = page;
+    if (m_window.isOpenEnded())
+        updateCountLabel();
+    updateButtons();
+}
+
+void QPageBar::finishScrub()
+{
+    // The pages are still on the page before the drag, so the switch activates pageRequested and pageChanged once
+    qint64 page = m_previewPage;
+    m_previewPage = 0;
+    if (page != 0 && page != m_window.currentPage() && isPageReachable(page))
+    {
+        setCurrentPage(page);
+    }
+    else
+    {
+        updateCountLabel();
+        updateButtons();
     }
+}
 
-    // 1. First, clear the existing page number buttons
-    clear();
+void QPageBar::resizeButtonPool(int count)
+{
+    if (m_updateDepth > 0)
+        return;
 
-    // 2. Initialize member variables
-    m_pageTotalCount = totalCount;
-    m_pageShowCount = showCount;
-    m_currentPage = 1;
-    m_pageStart = 1;
+    QHBoxLayout* hBoxLayout = qobject_cast<QHBoxLayout*>(layout());
 
-    m_countLabel->setText(tr("Total pages: ") + QString::number(m_pageTotalCount)); // set the count label text to show the total number of pages
+    // Disable the layout while the buttons change, so that it is only recalculated once at the end
+    hBoxLayout->setEnabled(false);
 
-    // 3. Add page number buttons and bind signals to them
-    for (int i = 0; i < showCount; i++)
+    // 1. Create the buttons that the pool is missing and bind signals to them
+    for (int i = m_pageButtons.size(); i < count; i++)
     {
-        QFont font;
-        font.setPointSize(10);
-        QPushButton* button = new QPushButton(QString::number(i + 1), this);
-        button->setFont(font);
-        qobject_cast<QHBoxLayout*>(layout())->insertWidget(i + 3, button);
-        button->setWhatsThis(QString::number(i + 1));
+        QPushButton* button = new QPushButton(this);
+        button->setFont(m_font);
         button->setCheckable(true);
+        hBoxLayout->insertWidget(i + 3, button);
         m_pageButtons.append(button);
+        m_buttonPages.append(-1);
         connect(button, &QPushButton::clicked, this, &QPageBar::onButtonClicked);
     }
-    m_pageButtons[0]->setChecked(true);
+
+    // 2. Show the buttons in use, the others are hidden and kept for the next setCount
+    for (int i = 0; i < m_pageButtons.size(); i++)
+    {
+        if (m_pageButtons[i]->isHidden() == (i < count))
+            m_pageButtons[i]->setVisible(i < count);
+    }
+
+    hBoxLayout->setEnabled(true);
+    hBoxLayout->activate();
 }
 
 void QPageBar::clear()
@@ -159,117 +380,796 @@ void QPageBar::clear()
         delete button;
     }
     m_pageButtons.clear();
-    m_pageShowCount = 0;
-    m_pageTotalCount = 0;
+    m_buttonPages.clear();
+    m_pageKeys.clear();
+    m_window.clear();
+    m_rowCount = -1;
+    m_quietTimer->stop();
+    m_maxDelayTimer->stop();
+    m_committedPage = m_window.currentPage();
+    updateButtons();
+    publishState();
 }
 
-int QPageBar::currentPage()
+qint64 QPageBar::currentPage()
 {
-    return m_currentPage;
+    return m_window.currentPage();
 }
 
-int QPageBar::pageCount()
+void QPageBar::setCurrentPage(qint64 page)
 {
-    return m_pageTotalCount;
+    // Like a click or a jump, keyset mode can only open pages with a known cursor
+    if (!isPageReachable(page)) // if no cursor is known for the page
+    {
+        qDebug() << "键集分页只能打开访问过的页面和它们的相邻页面"; // keyset mode can only open visited pages and their neighbours
+        return;
+    }
+
+    // A page set from code is replayed like a jump, so that the following clicks find the same buttons
+    if (!m_trace.isNull())
+        m_trace->record(QPageTrace::Jump, page);
+    moveToPage(page);
 }
 
-void QPageBar::onButtonClicked(bool checked)
+void QPageBar::beginUpdate()
 {
-    if (m_pageTotalCount == 0 || m_pageShowCount == 0)
+    // Nothing is painted until endUpdate
+    if (m_updateDepth++ == 0)
+        setUpdatesEnabled(false);
+}
+
+void QPageBar::endUpdate()
+{
+    if (m_updateDepth == 0 || --m_updateDepth > 0)
         return;
 
-    int index = qobject_cast<QPushButton*>(sender())->whatsThis().toInt();
-    switch (index)
+    // 1. One pass over the count label, the button pool and the buttons, then one repaint
+    updateCountLabel();
+    resizeButtonPool(m_window.cellCount());
+    updateButtons();
+    setUpdatesEnabled(true);
+    publishState();
+
+    // 2. The page switches of the batch are not coalesced, they are committed at once with the final page
+    if (m_window.currentPage() != m_committedPage)
     {
-    case -1:    // -1 is the < button
-        if (m_currentPage == 1)
-            break;
-        // If the current page is not the beginning, switch directly.
-        if (m_currentPage > m_pageStart)
+        emit pageRequested(m_window.currentPage());
+        commitPage();
+    }
+}
+
+qint64 QPageBar::pageCount()
+{
+    return m_window.totalCount();
+}
+
+QPageBar::Snapshot QPageBar::snapshot() const
+{
+    // Read again if updateSnapshot was writing in between
+    Snapshot snapshot;
+    quint32 sequence;
+    do
+    {
+        sequence = m_snapshotSequence.load(std::memory_order_acquire);
+        snapshot.currentPage = m_snapshotPage.load(std::memory_order_relaxed);
+        snapshot.pageCount = m_snapshotCount.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((sequence & 1) != 0 || sequence != m_snapshotSequence.load(std::memory_order_relaxed));
+    return snapshot;
+}
+
+void QPageBar::postTotalCount(qint64 totalCount)
+{
+    // Overwrites a value that has not been applied yet, only the first post of a turn queues applyPosted
+    m_postedTotalCount.store(qMax<qint64>(totalCount, 0));
+    if (!m_applyQueued.exchange(true))
+        QMetaObject::invokeMethod(this, [this]() { applyPosted(); }, Qt::QueuedConnection);
+}
+
+void QPageBar::postCurrentPage(qint64 page)
+{
+    if (page < 1)
+        return;
+    m_postedPage.store(page);
+    if (!m_applyQueued.exchange(true))
+        QMetaObject::invokeMethod(this, [this]() { applyPosted(); }, Qt::QueuedConnection);
+}
+
+void QPageBar::setElided(bool elided)
+{
+    if (!m_trace.isNull())
+        m_trace->record(QPageTrace::Elided, elided);
+    m_window.setElided(elided);
+    if (m_autoShowCount)
+    {
+        m_fittedShowCount = 0;
+        fitShowCount();
+    }
+    resizeButtonPool(m_window.cellCount());
+    updateButtons();
+}
+
+bool QPageBar::isElided()
+{
+    return m_window.isElided();
+}
+
+void QPageBar::setAutoShowCount(bool autoShowCount)
+{
+    if (autoShowCount == m_autoShowCount)
+        return;
+    m_autoShowCount = autoShowCount;
+
+    // Otherwise the layout keeps the bar as wide as all of its page buttons, and it could never shrink to fewer buttons
+    layout()->setSizeConstraint(m_autoShowCount ? QLayout::SetNoConstraint : QLayout::SetDefaultConstraint);
+    if (m_autoShowCount)
+    {
+        // The showCount of setCount and the minimum size are restored when the width no longer decides
+        m_manualShowCount = m_window.maxShowCount();
+        m_manualMinimumSize = minimumSize();
+        setMinimumSize(0, 0);
+        m_fittedShowCount = 0;
+        fitShowCount();
+    }
+    else
+    {
+        setMinimumSize(m_manualMinimumSize);
+        m_window.setShowCount(m_manualShowCount);
+    }
+    resizeButtonPool(m_window.cellCount());
+    updateButtons();
+    updateGeometry();
+}
+
+bool QPageBar::isAutoShowCount()
+{
+    return m_autoShowCount;
+}
+
+void QPageBar::setScrubSlider(bool enabled)
+{
+    if (enabled == (m_scrubSlider != nullptr))
+        return;
+    if (!enabled)
+    {
+        delete m_scrubSlider;
+        m_scrubSlider = nullptr;
+        if (m_previewPage != 0)
         {
-            m_pageButtons[m_currentPage - m_pageStart]->setChecked(false);
-            m_pageButtons[m_currentPage - m_pageStart - 1]->setChecked(true);
+            m_previewPage = 0;
+            updateCountLabel();
+            updateButtons();
         }
-        // If the current page is the beginning, shift the entire page to the previous one.
-        else
+        return;
+    }
+
+    // 1. The slider sits right after the > button, so the page buttons keep their positions in the layout
+    QHBoxLayout* hBoxLayout = qobject_cast<QHBoxLayout*>(layout());
+    m_scrubSlider = new QSlider(Qt::Horizontal, this);
+    m_scrubSlider->setMinimumWidth(100);
+    hBoxLayout->insertWidget(hBoxLayout->indexOf(m_nextButton) + 1, m_scrubSlider);
+
+    // 2. A drag only previews the pages until the release, clicks on the groove and keys switch the page at once
+    connect(m_scrubSlider, &QSlider::sliderReleased, this, &QPageBar::finishScrub);
+    connect(m_scrubSlider, &QSlider::valueChanged, this, [&](int value) {
+        if (m_scrubSlider->isSliderDown())
+            previewPage(scrubPage(value));
+        else if (isPageReachable(scrubPage(value)))
+            setCurrentPage(scrubPage(value));
+    });
+    updateScrubSlider();
+}
+
+bool QPageBar::hasScrubSlider()
+{
+    return m_scrubSlider != nullptr;
+}
+
+QSize QPageBar::minimumSizeHint() const
+{
+    // In auto mode the bar can shrink down to a single page button, or the first and last page with their ellipses in the elided layout
+    QSize size = QWidget::minimumSizeHint();
+    if (m_autoShowCount && m_cellWidth > 0)
+        size.setWidth(fixedWidth() + m_cellWidth * (m_window.isElided() ? 5 : 1));
+    return size;
+}
+
+void QPageBar::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+
+    // Only the visibility of pooled buttons changes, and only if the number of buttons that fit has changed
+    if (m_autoShowCount && fitShowCount())
+    {
+        resizeButtonPool(m_window.cellCount());
+        updateButtons();
+    }
+}
+
+bool QPageBar::eventFilter(QObject* watched, QEvent* event)
+{
+    // returnPressed is only activated for acceptable input, so an empty or too small page number would be ignored silently.
+    // The jump button reports the error instead
+    if (watched == m_pageLineEdit && event->type() == QEvent::KeyPress)
+    {
+        int key = static_cast<QKeyEvent*>(event)->key();
+        if (key == Qt::Key_Return || key == Qt::Key_Enter)
         {
-            for (int i = 0; i < m_pageShowCount; i++)
-            {
-                m_pageButtons[i]->setWhatsThis(QString::number(m_pageStart + i - 1));
-                m_pageButtons[i]->setText(QString::number(m_pageStart + i - 1));
-                m_pageButtons[i]->setChecked(false);
-            }
-            m_pageButtons[0]->setChecked(true);
-            m_pageStart--;
+            m_jumpButton->click();
+            return true;
         }
-        m_currentPage--;
-        emit pageChanged(m_currentPage);
-        
-        // If it has reached the end, disable the > button. This line restores it.
-        m_nextButton->setEnabled(true);
-        
-        // If it has reached the beginning, disable the < button.
-        if (m_currentPage == 1)
-            m_previousButton->setEnabled(false);
-        
-        break;
-
-    case -2: // -2 represents the > button
-        if (m_currentPage == m_pageTotalCount)
-            break;
-        // If the current page is not the end of the displayed pages, switch directly
-        if (m_currentPage < m_pageStart + m_pageShowCount - 1)
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+void QPageBar::changeEvent(QEvent* event)
+{
+    QWidget::changeEvent(event);
+
+    // Another style has other button margins
+    if (event->type() == QEvent::StyleChange && m_autoShowCount)
+    {
+        m_cellWidth = 0;
+        if (fitShowCount())
         {
-            m_pageButtons[m_currentPage - m_pageStart]->setChecked(false);
-            m_pageButtons[m_currentPage - m_pageStart + 1]->setChecked(true);
+            resizeButtonPool(m_window.cellCount());
+            updateButtons();
         }
-        // If the current page is the end of the displayed pages, shift the entire list to the right
+    }
+}
+
+void QPageBar::setCoalescing(int quietTime, int maxDelay)
+{
+    // The intervals of the timers are the settings, an interval of 0 means disabled
+    m_quietTimer->setInterval(quietTime);
+    m_maxDelayTimer->setInterval(maxDelay);
+    if (quietTime == 0)
+        commitPage();
+}
+
+void QPageBar::setPageProvider(QPageProvider* provider)
+{
+    // The running request belongs to the old provider
+    m_pageWatcher->future().cancel();
+    m_pageWatcher->setFuture(QFuture<QVariant>());
+    setLoadingPage(0);
+    m_pageProvider = provider;
+}
+
+qint64 QPageBar::loadingPage()
+{
+    return m_loadingPage;
+}
+
+void QPageBar::reload()
+{
+    loadPage();
+}
+
+void QPageBar::setPageSize(qint64 pageSize)
+{
+    if (pageSize <= 0 || pageSize == m_pageSize)
+        return;
+    if (!m_trace.isNull())
+        m_trace->record(QPageTrace::PageSize, pageSize);
+
+    // 1. The first row shown before the change, the page size of the combo box follows
+    qint64 firstRow = (m_committedPage - 1) * m_pageSize;
+    bool anchored = m_rowCount >= 0 && m_pageSize > 0;
+    m_pageSize = pageSize;
+    updatePageSizeBox();
+
+    // 2. The keys were reported for the pages of the old size, they don't mark the new pages
+    m_pageKeys.clear();
+    if (m_keyIndex != nullptr)
+        m_keyIndex->clear();
+
+    // 3. With the number of rows, the pages are derived again and the page of the first row becomes current, in one batch.
+    //    Keyset mode has no cursor for it any more and starts again from page 1
+    if (anchored)
+    {
+        qint64 totalCount = (m_rowCount + m_pageSize - 1) / m_pageSize;
+        qint64 page = firstRow / m_pageSize + 1;
+        if (!isPageReachable(page))
+            page = 1;
+        beginUpdate();
+        updateTotalCount(totalCount);
+        moveToPage(page);
+
+        // The rows of the page change even if its number doesn't, so endUpdate commits it again
+        m_committedPage = 0;
+        endUpdate();
+    }
+    else
+    {
+        // Without the keys fewer pages are reachable
+        updateButtons();
+    }
+    emit pageSizeChanged(m_pageSize);
+}
+
+qint64 QPageBar::pageSize()
+{
+    return m_pageSize;
+}
+
+void QPageBar::setPageSizeOptions(const QVector<qint64>& pageSizes)
+{
+    if (pageSizes.isEmpty())
+    {
+        delete m_pageSizeBox;
+        m_pageSizeBox = nullptr;
+        return;
+    }
+
+    // 1. The combo box is added at the end of the layout, so the page buttons keep their positions in it
+    if (m_pageSizeBox == nullptr)
+    {
+        m_pageSizeBox = new QComboBox(this);
+        m_pageSizeBox->setFont(m_font);
+        layout()->addWidget(m_pageSizeBox);
+        connect(m_pageSizeBox, QOverload<int>::of(&QComboBox::activated), this, [&](int index) {
+            setPageSize(m_pageSizeBox->itemData(index).toLongLong());
+        });
+    }
+
+    // 2. Without a page size the first option is set like a choice in the combo box, so pageSizeChanged and the trace see it
+    if (m_pageSize <= 0)
+        setPageSize(pageSizes.first());
+
+    // 3. Fill the options and select the current page size
+    m_pageSizeBox->clear();
+    for (qint64 pageSize : pageSizes)
+        m_pageSizeBox->addItem(tr("%1 / page").arg(pageSize), pageSize);
+    updatePageSizeBox();
+}
+
+void QPageBar::setKeysetMode(bool keysetMode)
+{
+    if (!m_trace.isNull())
+        m_trace->record(QPageTrace::KeysetMode, keysetMode);
+    m_keysetMode = keysetMode;
+    updateButtons();
+}
+
+bool QPageBar::isKeysetMode()
+{
+    return m_keysetMode;
+}
+
+void QPageBar::setPageKeys(qint64 page, const QVariant& firstKey, const QVariant& lastKey)
+{
+    m_pageKeys.insert(page, qMakePair(firstKey, lastKey));
+    updateButtons();
+}
+
+void QPageBar::clearPageKeys()
+{
+    m_pageKeys.clear();
+    updateButtons();
+}
+
+void QPageBar::setKeyIndex(QPageKeyIndex* index)
+{
+    m_keyIndex = index;
+    // Keys are not page numbers
+    m_pageLineEdit->setValidator(m_keyIndex != nullptr ? nullptr : m_pageValidator);
+}
+
+qint64 QPageBar::jumpToKey(const QVariant& key)
+{
+    if (m_keyIndex == nullptr)
+        return 0;
+
+    // The same window shift as jumping to a page number
+    m_keyIndex->setPageCount(m_window.totalCount());
+    qint64 page = m_keyIndex->pageOf(key);
+    if (!m_window.contains(page) || !isPageReachable(page))
+        return 0;
+    if (!m_trace.isNull())
+        m_trace->record(QPageTrace::Jump, page);
+    moveToPage(page);
+    return page;
+}
+
+void QPageBar::setLatencyTracking(bool enabled)
+{
+    if (enabled && m_latencyTracker == nullptr)
+    {
+        m_latencyTracker = new QPageLatencyTracker(this);
+    }
+    else if (!enabled)
+    {
+        delete m_latencyTracker;
+        m_latencyTracker = nullptr;
+    }
+}
+
+QPageLatencyTracker* QPageBar::latencyTracker()
+{
+    return m_latencyTracker;
+}
+
+void QPageBar::setTraceDevice(QIODevice* device)
+{
+    // A new device starts a new trace with its own header
+    m_trace.reset(device != nullptr ? new QPageTrace(device) : nullptr);
+
+    // The trace starts with the current settings, count and page, so that the replay finds the same buttons
+    if (m_trace.isNull())
+        return;
+    if (m_pageSize > 0)
+        m_trace->record(QPageTrace::PageSize, m_pageSize);
+    if (m_window.isElided())
+        m_trace->record(QPageTrace::Elided, 1);
+    if (m_keysetMode)
+        m_trace->record(QPageTrace::KeysetMode, 1);
+    if (!m_window.isEmpty())
+    {
+        if (m_window.isOpenEnded())
+            m_trace->record(QPageTrace::EstimatedCount, m_window.totalCount(), m_window.showCount());
+        else if (m_rowCount >= 0)
+            m_trace->record(QPageTrace::RowCount, m_rowCount, m_window.showCount());
         else
-        {
-            for (int i = 0; i < m_pageShowCount; i++)
-            {
-                m_pageButtons[i]->setWhatsThis(QString::number(m_pageStart + i + 1));
-                m_pageButtons[i]->setText(QString::number(m_pageStart + i + 1));
-                m_pageButtons[i]->setChecked(false);
-            }
-            m_pageButtons[m_pageShowCount - 1]->setChecked(true);
-            m_pageStart++;
-        }
-        m_currentPage++;
-        emit pageChanged(m_currentPage);
+            m_trace->record(QPageTrace::Count, m_window.totalCount(), m_window.showCount());
+        if (m_window.currentPage() != 1)
+            m_trace->record(QPageTrace::Jump, m_window.currentPage());
+    }
+}
 
-        // If we have reached the beginning of the list, re-enable the < button
-        m_previousButton->setEnabled(true);
+void QPageBar::setModel(QPageBarModel* model)
+{
+    if (m_model != nullptr)
+        disconnect(m_model, nullptr, this, nullptr);
+    m_model = model;
+    if (m_model == nullptr)
+        return;
 
-        // If we have reached the end of the list, disable the > button
-        if (m_currentPage == m_pageTotalCount)
-            m_nextButton->setEnabled(false);
+    connect(m_model, &QPageBarModel::stateChanged, this, &QPageBar::onModelStateChanged);
+    connect(m_model, &QObject::destroyed, this, [this]() { m_model = nullptr; });
+    // The first bar fills an empty model, the following bars show its pages
+    if (m_model->window().isEmpty())
+        publishState();
+    else
+        onModelStateChanged(nullptr);
+}
 
-        break;
+QPageBarModel* QPageBar::model()
+{
+    return m_model;
+}
 
-    default: // All other cases represent individual page buttons
-        m_pageButtons[index - m_pageStart]->setChecked(true);
-        if (index == m_currentPage)
-            break;
-        m_pageButtons[m_currentPage - m_pageStart]->setChecked(false);
-        if (index == 1)
-        {
-            m_previousButton->setEnabled(false);
-            m_nextButton->setEnabled(true);
-        }
-        else if (index == m_pageTotalCount)
+void QPageBar::pageReady(qint64 page)
+{
+    if (m_latencyTracker != nullptr)
+        m_latencyTracker->markReady(page);
+}
+
+bool QPageBar::isPageReachable(qint64 page)
+{
+    // Page 1 starts at the first row, every other page needs its own keys or the keys of a neighbour
+    return !m_keysetMode || page == 1 || m_pageKeys.contains(page) || m_pageKeys.contains(page - 1) || m_pageKeys.contains(page + 1);
+}
+
+void QPageBar::requestKeyset()
+{
+    qint64 page = m_committedPage;
+
+    // Prefer the page's own first key, then the last key of the page before, then the first key of the page after
+    auto keys = m_pageKeys.constFind(page);
+    if (keys != m_pageKeys.constEnd())
+    {
+        emit keysetRequested(page, keys->first, SeekFrom);
+        return;
+    }
+    keys = m_pageKeys.constFind(page - 1);
+    if (keys != m_pageKeys.constEnd())
+    {
+        emit keysetRequested(page, keys->second, SeekAfter);
+        return;
+    }
+    keys = m_pageKeys.constFind(page + 1);
+    if (keys != m_pageKeys.constEnd())
+    {
+        emit keysetRequested(page, keys->first, SeekBefore);
+        return;
+    }
+    emit keysetRequested(page, QVariant(), SeekFrom);
+}
+
+void QPageBar::onButtonClicked(bool checked)
+{
+    if (m_window.isEmpty())
+        return;
+
+    QPushButton* button = qobject_cast<QPushButton*>(sender());
+    if (button == m_previousButton)
+    {
+        if (!m_trace.isNull())
+            m_trace->record(QPageTrace::Previous);
+        moveToPage(m_window.currentPage() - 1);
+    }
+    else if (button == m_nextButton)
+    {
+        if (!m_trace.isNull())
+            m_trace->record(QPageTrace::Next);
+        // Past the end of an estimated count the next page is assumed to exist, until setTotalCount reports the end
+        if (m_window.isOpenEnded() && m_window.currentPage() == m_window.totalCount())
+            updateTotalCount(m_window.totalCount() + 1);
+        moveToPage(m_window.currentPage() + 1);
+    }
+    else // All other cases represent individual page buttons, whose page number comes from their position in the window
+    {
+        qint64 page = m_window.cellPage(int(m_pageButtons.indexOf(button)));
+        if (!m_trace.isNull())
+            m_trace->record(QPageTrace::Page, page);
+        moveToPage(page);
+    }
+}
+
+void QPageBar::moveToPage(qint64 page)
+{
+    if (m_latencyTracker != nullptr)
+        m_latencyTracker->markInput();
+
+    bool changed = m_window.setCurrentPage(page);
+
+    // Always sync the buttons: clicking the checked page button unchecks it
+    updateButtons();
+    if (!changed || m_updateDepth > 0)
+        return;
+    publishState();
+
+    // "Page n of many" shows the current page
+    if (m_window.isOpenEnded())
+        updateCountLabel();
+
+    emit pageRequested(m_window.currentPage());
+
+    // With coalescing, pageChanged waits until the page stops changing
+    if (m_quietTimer->interval() > 0)
+    {
+        m_quietTimer->start();
+        if (m_maxDelayTimer->interval() > 0 && !m_maxDelayTimer->isActive())
+            m_maxDelayTimer->start();
+    }
+    else
+    {
+        commitPage();
+    }
+}
+
+void QPageBar::commitPage()
+{
+    if (m_updateDepth > 0)
+        return;
+
+    m_quietTimer->stop();
+    m_maxDelayTimer->stop();
+
+    // Switching back to the committed page doesn't need a new pageChanged
+    if (m_committedPage == m_window.currentPage())
+        return;
+    m_committedPage = m_window.currentPage();
+    if (m_latencyTracker != nullptr)
+        m_latencyTracker->markChanged(m_committedPage);
+    emit pageChanged(m_committedPage);
+    if (m_latencyTracker != nullptr)
+        m_latencyTracker->markDispatched();
+    if (m_model != nullptr)
+        m_model->commitPage(m_committedPage);
+    if (m_pageSize > 0)
+        emit pageRangeChanged((m_committedPage - 1) * m_pageSize, m_pageSize);
+    if (m_keysetMode)
+        requestKeyset();
+    loadPage();
+}
+
+void QPageBar::loadPage()
+{
+    if (m_pageProvider == nullptr)
+        return;
+
+    // Cancel the request of the previous page, setFuture also drops its pending finished signal
+    m_pageWatcher->future().cancel();
+    qint64 page = m_committedPage;
+    m_pageWatcher->setFuture(m_pageProvider->requestPage(page));
+    setLoadingPage(page);
+}
+
+void QPageBar::onPageLoaded()
+{
+    QFuture<QVariant> future = m_pageWatcher->future();
+    qint64 page = m_loadingPage;
+    setLoadingPage(0);
+
+    // Results of cancelled requests, failed requests and pages that are no longer current are stale
+    if (future.isCanceled() || future.resultCount() == 0 || page != m_committedPage)
+        return;
+    emit pageLoaded(page, future.result());
+}
+
+void QPageBar::setLoadingPage(qint64 page)
+{
+    m_loadingPage = page;
+    updateButtons();
+}
+
+bool QPageBar::fitShowCount()
+{
+    int showCount = fittedShowCount();
+    if (showCount == m_fittedShowCount)
+        return false;
+    m_fittedShowCount = showCount;
+    m_window.setShowCount(showCount);
+    return true;
+}
+
+int QPageBar::fittedShowCount()
+{
+    // 1. The width of a page button for the largest page number, measured once per number of digits
+    int digits = int(QString::number(qMax<qint64>(m_window.totalCount(), 1)).size());
+    if (m_cellWidth == 0 || digits != m_cellDigits)
+    {
+        QFontMetrics fontMetrics(m_font);
+        QStyleOptionButton option;
+        option.initFrom(m_previousButton);
+        option.fontMetrics = fontMetrics;
+        option.text = QString(digits, QLatin1Char('0'));
+        QSize textSize = fontMetrics.size(Qt::TextShowMnemonic, option.text);
+        m_cellWidth = style()->sizeFromContents(QStyle::CT_PushButton, &option, textSize, m_previousButton).width() + layout()->spacing();
+        m_cellDigits = digits;
+        updateGeometry();
+    }
+
+    // 2. The page buttons share the width left by the other widgets, the elided layout needs 4 of them for the first and the last page and the ellipses
+    int showCount = (width() - fixedWidth()) / m_cellWidth;
+    if (m_window.isElided())
+        showCount -= 4;
+    return qMax(showCount, 1);
+}
+
+int QPageBar::fixedWidth() const
+{
+    QHBoxLayout* hBoxLayout = qobject_cast<QHBoxLayout*>(layout());
+    QMargins margins = hBoxLayout->contentsMargins();
+    int width = margins.left() + margins.right();
+
+    // The page buttons are inserted after the stretch, the count label and the < button. Hidden widgets and the stretch take no width
+    for (int i = 0; i < hBoxLayout->count(); i++)
+    {
+        QLayoutItem* item = hBoxLayout->itemAt(i);
+        if ((i >= 3 && i < 3 + m_pageButtons.size()) || item->isEmpty())
+            continue;
+        width += item->sizeHint().width() + hBoxLayout->spacing();
+    }
+    return width;
+}
+
+void QPageBar::setInputError(const QString& message)
+{
+    // A tool tip instead of a modal message box, so the event loop and with it loading and timers keep running
+    bool error = !message.isEmpty();
+    m_pageLineEdit->setToolTip(message);
+    if (error)
+        QToolTip::showText(m_pageLineEdit->mapToGlobal(QPoint(0, m_pageLineEdit->height())), message, m_pageLineEdit);
+
+    // The "error" property can be used in style sheets, e.g. QLineEdit[error="true"] { border: 1px solid red; }
+    if (m_pageLineEdit->property("error").toBool() != error)
+    {
+        m_pageLineEdit->setProperty("error", error);
+        if (!error)
+            QToolTip::hideText();
+        m_pageLineEdit->style()->unpolish(m_pageLineEdit);
+        m_pageLineEdit->style()->polish(m_pageLineEdit);
+    }
+}
+
+void QPageBar::publishState()
+{
+    // Inside beginUpdate/endUpdate, endUpdate reports the final pages once
+    if (m_model != nullptr && m_updateDepth == 0)
+        m_model->setState(m_window, m_estimatedCount, this);
+}
+
+void QPageBar::onModelStateChanged(QObject* source)
+{
+    if (source == this)
+        return;
+
+    // 1. Take over the shared pages, the layout and the number of page buttons stay the ones of this bar.
+    //    The replay feeds the same pages to its model
+    if (!m_trace.isNull())
+        m_trace->recordModelState(m_model->window(), m_model->estimatedCount());
+    bool elided = m_window.isElided();
+    int showCount = m_window.maxShowCount();
+    m_window = m_model->window();
+    m_window.setShowCount(showCount);
+    m_window.setElided(elided);
+    if (m_autoShowCount)
+    {
+        m_fittedShowCount = 0;
+        fitShowCount();
+    }
+    m_estimatedCount = m_model->estimatedCount();
+
+    // 2. The page switch belongs to another bar, so a pending pageChanged of this bar is dropped and none is activated
+    m_quietTimer->stop();
+    m_maxDelayTimer->stop();
+    m_committedPage = m_window.currentPage();
+
+    updateCountLabel();
+    resizeButtonPool(m_window.cellCount());
+    updateButtons();
+}
+
+void QPageBar::applyPosted()
+{
+    // 1. Posts from now on queue the next apply, so no value is left behind
+    m_applyQueued.store(false);
+    qint64 totalCount = m_postedTotalCount.exchange(-1);
+    qint64 page = m_postedPage.exchange(0);
+
+    // 2. The total first, so that the page is within it, and pageChanged at most once
+    beginUpdate();
+    if (totalCount >= 0)
+        setTotalCount(totalCount);
+    if (page > 0 && page <= m_window.totalCount())
+        setCurrentPage(page);
+    endUpdate();
+}
+
+void QPageBar::updateSnapshot()
+{
+    // A seqlock with a single writer, see snapshot
+    quint32 sequence = m_snapshotSequence.load(std::memory_order_relaxed);
+    m_snapshotSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_snapshotPage.store(m_window.currentPage(), std::memory_order_relaxed);
+    m_snapshotCount.store(m_window.totalCount(), std::memory_order_relaxed);
+    m_snapshotSequence.store(sequence + 2, std::memory_order_release);
+}
+
+void QPageBar::updateButtons()
+{
+    if (m_updateDepth > 0)
+        return;
+
+    updateSnapshot();
+
+    // While the scrub slider is dragged, the buttons are painted from a copy of the pages on the previewed page
+    PageWindow window = m_window;
+    if (m_previewPage != 0)
+        window.setCurrentPage(m_previewPage);
+
+    for (int i = 0; i < window.cellCount(); i++)
+    {
+        // Only the buttons whose page has changed get a new label, an ellipsis is a disabled button
+        qint64 page = window.cellPage(i);
+        if (m_buttonPages[i] != page)
         {
-            m_nextButton->setEnabled(false);
-            m_previousButton->setEnabled(true);
+            m_buttonPages[i] = page;
+            m_pageButtons[i]->setText(page == 0 ? QString(QChar(0x2026)) : QString::number(page));
         }
-        else
+        m_pageButtons[i]->setEnabled(page != 0 && isPageReachable(page));
+        m_pageButtons[i]->setChecked(page == window.currentPage());
+
+        // The button of the page being loaded has the "loading" property, which can be used in style sheets
+        bool loading = m_loadingPage != 0 && page == m_loadingPage;
+        if (m_pageButtons[i]->property("loading").toBool() != loading)
         {
-            m_previousButton->setEnabled(true);
-            m_nextButton->setEnabled(true);
+            m_pageButtons[i]->setProperty("loading", loading);
+            if (loading)
+                m_pageButtons[i]->setCursor(Qt::BusyCursor);
+            else
+                m_pageButtons[i]->unsetCursor();
+            m_pageButtons[i]->style()->unpolish(m_pageButtons[i]);
+            m_pageButtons[i]->style()->polish(m_pageButtons[i]);
         }
-        m_currentPage = index;
-        emit pageChanged(m_currentPage);
-
-        break;
     }
+
+    // Disable the < button on the first page and the > button on the last page
+    m_previousButton->setEnabled(window.canGoPrevious() && isPageReachable(window.currentPage() - 1));
+    m_nextButton->setEnabled(window.canGoNext() && isPageReachable(window.currentPage() + 1));
+    updateScrubSlider();
 }
@@ -5,7 +5,24 @@
 #include <QPushButton>
 #include <QLabel>
 #include <QLineEdit>
+#include <QComboBox>
+#include <QSlider>
 #include <QVector>
+#include <QTimer>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QPair>
+#include <QVariant>
+#include <QScopedPointer>
+#include <atomic>
+
+#include "pagewindow.h"
+#include "qpageprovider.h"
+#include "qpagekeyindex.h"
+#include "qpagelatency.h"
+#include "qpagetrace.h"
+#include "qpagebarmodel.h"
+#include "qpagenumbervalidator.h"
 
 /**
 * @brief This class is a widget for switching page numbers, similar to the ones at the bottom of a forum.
@@ -14,6 +31,17 @@ class QPageBar : public QWidget
 {
     Q_OBJECT
 public:
+    /**
+    * @brief How keysetRequested finds the rows of a page in keyset mode
+    */
+    enum KeysetSeek
+    {
+        SeekFrom,       // The rows with key >= the first key of the page itself, or from the first row if the key is invalid
+        SeekAfter,      // The rows with key > the last key of the page before
+        SeekBefore      // The rows with key < the first key of the page after, in descending order
+    };
+    Q_ENUM(KeysetSeek)
+
     explicit QPageBar(QWidget* parent = nullptr);
     
     /**
@@ -21,17 +49,63 @@ public:
     * @param pageTotalCount Total number of pages
     * @param pageShowCount Number of page buttons to show
     */
-    explicit QPageBar(int pageTotalCount, int pageShowCount = 5, QWidget* parent = nullptr);
+    explicit QPageBar(qint64 pageTotalCount, int pageShowCount = 5, QWidget* parent = nullptr);
 
     /**
-    * @brief Set the number of pages, where totalCount must be greater than or equal to showCount
+    * @brief Set the number of pages. showCount is clamped to totalCount and grows back when setTotalCount raises the total,
+    *        so a bar can start with setCount(0, showCount). The existing page buttons are reused, so calling this frequently is cheap
     * @param totalCount Total number of pages
     * @param showCount Number of page buttons to show
     */
-    void setCount(int totalCount, int showCount);
+    void setCount(qint64 totalCount, int showCount);
+
+    /**
+    * @brief Set the total number of rows instead of pages, the number of pages follows from setPageSize. Goes back to page 1 like setCount.
+    *        Unlike with setCount, a later page size change keeps the current rows in view, see setPageSize
+    * @param rowCount Total number of rows
+    * @param showCount Number of page buttons to show
+    */
+    void setRowCount(qint64 rowCount, int showCount);
+
+    /**
+    * @brief Get the total number of rows of setRowCount
+    * @return The number of rows, or -1 if the total was set in pages
+    */
+    qint64 rowCount();
+
+    /**
+    * @brief Change only the total number of pages, e.g. while a streaming query is still growing the result set.
+    *        The current page and the page buttons are kept, the count label and the > button are updated.
+    *        If the total drops below the number of page buttons, the surplus buttons are hidden, and they come back when it grows again.
+    *        If the current page no longer exists, the last page becomes current and pageChanged is activated.
+    *        After setEstimatedCount, this reports the exact total and ends the estimated mode
+    * @param totalCount Total number of pages, 0 for none
+    */
+    void setTotalCount(qint64 totalCount);
+
+    /**
+    * @brief Show the page bar before the exact total is known, e.g. instead of running COUNT(*) up front. Goes back to page 1 like setCount.
+    *        The count label shows "~estimate", or "Page n of many" if the estimate is 0, and the > button stays enabled on the last page,
+    *        adding a page each time, until setTotalCount reports the exact total
+    * @param estimate Estimated total number of pages, 0 if unknown
+    * @param showCount Number of page buttons to show
+    */
+    void setEstimatedCount(qint64 estimate, int showCount);
 
     /**
-    * @brief Clear the page buttons and page count
+    * @brief Refine the estimate of setEstimatedCount, keeping the current page and the page buttons like setTotalCount.
+    *        Ignored once the exact total is known
+    * @param estimate Estimated total number of pages, 0 if unknown
+    */
+    void setEstimate(qint64 estimate);
+
+    /**
+    * @brief Whether the total number of pages is exact, false after setEstimatedCount until setTotalCount or setCount
+    */
+    bool isCountExact();
+
+    /**
+    * @brief Clear the page count and delete the page buttons, including the ones kept for reuse by setCount
     */
     void clear();
 
@@ -39,20 +113,255 @@ public:
     * @brief Get the current page number
     * @return The current page number
     */
-    int currentPage();
+    qint64 currentPage();
+
+    /**
+    * @brief Switch to the given page from code, e.g. when restoring a view. Activates pageChanged like a click
+    * @param page The page number, must be within 1~totalCount. In keyset mode it must be page 1, a visited page or one of their neighbours
+    */
+    void setCurrentPage(qint64 page);
+
+    /**
+    * @brief Start a batch of changes, e.g. setCount followed by setCurrentPage. Until the matching endUpdate, the buttons are not
+    *        updated and no signals are activated. Calls can be nested, only the outermost endUpdate finishes the batch
+    */
+    void beginUpdate();
+
+    /**
+    * @brief Finish a batch of changes: the count label and the buttons are updated and repainted once,
+    *        and pageRequested and pageChanged are activated at most once, with the final page
+    */
+    void endUpdate();
 
     /**
     * @brief Get the total number of pages
     * @return The total number of pages
     */
-    int pageCount();
+    qint64 pageCount();
+
+    /**
+    * @brief The current page and the total number of pages of the same moment, see snapshot
+    */
+    struct Snapshot
+    {
+        qint64 currentPage;
+        qint64 pageCount;
+    };
+
+    /**
+    * @brief Thread-safe: get the current page and the total number of pages as shown by the buttons, e.g. in a worker thread.
+    *        Both values belong to the same state, and reading them takes no lock
+    */
+    Snapshot snapshot() const;
+
+    /**
+    * @brief Thread-safe: report the total number of pages from any thread, e.g. from a worker that ingests rows.
+    *        Only the newest value is kept, and it is applied with setTotalCount at most once per event loop turn in the thread
+    *        of the page bar, so a worker can post far more often than the bar is rebuilt. The page bar must outlive the call
+    * @param totalCount Total number of pages, 0 for none
+    */
+    void postTotalCount(qint64 totalCount);
+
+    /**
+    * @brief Thread-safe: switch to the given page from any thread. Applied like setCurrentPage, after a total posted in the same turn
+    * @param page The page number
+    */
+    void postCurrentPage(qint64 page);
+
+    /**
+    * @brief Switch to the elided layout "1 … 498 499 [500] 501 502 … 1000000", which shows showCount pages around the current page
+    *        together with the first and the last page. The number of buttons stays fixed, and only the buttons whose page changes are relabeled
+    * @param elided Whether to use the elided layout
+    */
+    void setElided(bool elided);
+    bool isElided();
+
+    /**
+    * @brief Derive the number of page buttons from the available width instead of the showCount of setCount. The width of a button
+    *        for the largest page number is cached, and resizing only shows or hides buttons of the pool, so many bars resize smoothly.
+    *        The bar can then shrink down to a single page button. Turning it off restores the showCount of setCount and the minimum size
+    * @param autoShowCount Whether to fit the page buttons to the width
+    */
+    void setAutoShowCount(bool autoShowCount);
+    bool isAutoShowCount();
+
+    /**
+    * @brief Show a slider after the > button for moving across a large number of pages. While it is dragged, the page buttons
+    *        preview the page under the handle without activating any signal, and the page is switched once when it is released,
+    *        so a long drag loads only one page. Until then currentPage and snapshot keep the page before the drag.
+    *        Clicks on the groove and the arrow keys switch the page at once.
+    *        With more pages than the slider has steps, each step skips several pages
+    * @param enabled Whether to show the slider
+    */
+    void setScrubSlider(bool enabled);
+    bool hasScrubSlider();
+
+    QSize minimumSizeHint() const override;
+
+    /**
+    * @brief Coalesce page switches: pageRequested is still activated on every switch, but pageChanged is only activated
+    *        with the final page, once no page was switched for quietTime ms, or at the latest maxDelay ms after the first switch
+    * @param quietTime Quiet period in ms, 0 disables coalescing so that pageChanged is activated on every switch
+    * @param maxDelay Maximum delay in ms, 0 means no maximum
+    */
+    void setCoalescing(int quietTime, int maxDelay = 0);
+
+    /**
+    * @brief Set the provider that loads the pages. Whenever pageChanged is activated, the page is requested from the provider,
+    *        a request that is still running is cancelled, and the page button shows a loading state until pageLoaded
+    * @param provider The provider, not owned by the page bar. nullptr removes the provider
+    */
+    void setPageProvider(QPageProvider* provider);
+
+    /**
+    * @brief Get the page that is being loaded by the provider
+    * @return The page number, or 0 if no page is loading
+    */
+    qint64 loadingPage();
+
+    /**
+    * @brief Request the current page from the provider again, e.g. after the data has changed or after setCount,
+    *        which goes back to page 1 without activating pageChanged
+    */
+    void reload();
+
+    /**
+    * @brief Set the number of rows per page. If it is greater than 0, pageRangeChanged is activated together with pageChanged.
+    *        After setRowCount, the number of pages is derived again and the page that contains the first row of the current page
+    *        becomes current, then pageChanged and pageRangeChanged are activated once, even if the page number stays the same.
+    *        Otherwise the number of pages is left to the caller, e.g. in a slot connected to pageSizeChanged.
+    *        The keys of setPageKeys and the key index are cleared, so in keyset mode the page after setRowCount is page 1
+    * @param pageSize Number of rows per page, must be greater than 0
+    */
+    void setPageSize(qint64 pageSize);
+    qint64 pageSize();
+
+    /**
+    * @brief Show a combo box for the number of rows per page at the end of the bar, which calls setPageSize.
+    *        If no page size is set yet, the first option becomes the page size and pageSizeChanged is activated
+    * @param pageSizes The page sizes to choose from, e.g. {25, 50, 100, 500}. Empty removes the combo box
+    */
+    void setPageSizeOptions(const QVector<qint64>& pageSizes);
+
+    /**
+    * @brief Switch to keyset pagination: instead of an offset, keysetRequested passes a cursor to seek the page from,
+    *        taken from the keys reported with setPageKeys. Only pages whose cursor is known, i.e. page 1, visited pages and
+    *        their neighbours, can be opened, so the </> buttons are disabled until the keys of the current page are reported
+    * @param keysetMode Whether to use keyset pagination
+    */
+    void setKeysetMode(bool keysetMode);
+    bool isKeysetMode();
+
+    /**
+    * @brief Report the first and the last key of a loaded page, which become the cursors of this page and its neighbours
+    * @param page The page number
+    * @param firstKey The key of the first row of the page
+    * @param lastKey The key of the last row of the page
+    */
+    void setPageKeys(qint64 page, const QVariant& firstKey, const QVariant& lastKey);
+
+    /**
+    * @brief Forget all keys, e.g. after the data has changed. setCount also does this
+    */
+    void clearPageKeys();
+
+    /**
+    * @brief Set the index used to jump to a key. The text of the page number input box is then looked up as a key,
+    *        e.g. a customer ID or a timestamp, instead of a page number
+    * @param index The index, not owned by the page bar. nullptr goes back to page numbers
+    */
+    void setKeyIndex(QPageKeyIndex* index);
+
+    /**
+    * @brief Switch to the page that contains key, found with the index of setKeyIndex in O(log n)
+    * @param key The key to look up
+    * @return The page number, or 0 if no index is set, the page could not be found or cannot be opened in keyset mode
+    */
+    qint64 jumpToKey(const QVariant& key);
+
+    /**
+    * @brief Measure how long each navigation takes: from the input to pageChanged, the slots connected to pageChanged,
+    *        and from pageChanged to pageReady. While disabled, each navigation only costs a pointer check
+    * @param enabled Whether to measure, disabling drops the collected latencies
+    */
+    void setLatencyTracking(bool enabled);
+
+    /**
+    * @brief The latencies collected since setLatencyTracking(true)
+    * @return The tracker, owned by the page bar, or nullptr while disabled
+    */
+    QPageLatencyTracker* latencyTracker();
+
+    /**
+    * @brief Record every click, jump and count change with a timestamp into a compact binary trace, see QPageTrace.
+    *        The trace can be replayed headless with tools/QPageBarReplay, e.g. to reproduce a slow session.
+    *        While no device is set, each navigation only costs a pointer check
+    * @param device The open device to write to, not owned by the page bar. nullptr stops recording
+    */
+    void setTraceDevice(QIODevice* device);
+
+    /**
+    * @brief Share the pages with other bars, e.g. one above and one below a table. A navigation in any bar is shown by all of them,
+    *        and the model activates pageChanged once for it, so connect the backend to the model. Only the bar that made the
+    *        navigation activates its own signals and requests the page from its provider, the other bars just follow.
+    *        The first bar fills an empty model with its pages, the following bars take over the pages of the model
+    * @param model The model, not owned by the page bar. nullptr detaches the bar, which keeps the current pages
+    */
+    void setModel(QPageBarModel* model);
+    QPageBarModel* model();
+
+public slots:
+    /**
+    * @brief Report that the content of page is shown, which ends the navigation for the latency tracking
+    * @param page The page number
+    */
+    void pageReady(qint64 page);
 
 signals:
     /**
-    * @brief This signal will be activated when a page is switched
+    * @brief This signal will be activated when a page is switched. If coalescing is enabled, it is only activated with the final page
+    * @param page The page number
+    */
+    void pageChanged(qint64 page);
+
+    /**
+    * @brief This signal will be activated immediately on every page switch, even if coalescing is enabled
+    * @param page The page number
+    */
+    void pageRequested(qint64 page);
+
+    /**
+    * @brief This signal will be activated together with pageChanged if a page size is set, the parameters can be used in LIMIT/OFFSET directly
+    * @param offset The index of the first row of the page, (page - 1) * pageSize
+    * @param limit The number of rows per page
+    */
+    void pageRangeChanged(qint64 offset, qint64 limit);
+
+    /**
+    * @brief This signal will be activated when the number of rows per page changes, e.g. in the combo box of setPageSizeOptions
+    * @param pageSize Number of rows per page
+    */
+    void pageSizeChanged(qint64 pageSize);
+
+    /**
+    * @brief This signal will be activated together with pageChanged in keyset mode, the parameters can be used in a WHERE clause on the key
+    * @param page The page number
+    * @param key The cursor to seek from, invalid for the first page
+    * @param seek How the rows of the page are found from the cursor
+    */
+    void keysetRequested(qint64 page, const QVariant& key, QPageBar::KeysetSeek seek);
+
+    /**
+    * @brief This signal will be activated when the provider has loaded the current page. Results of cancelled or outdated requests are dropped
     * @param page The page number
+    * @param data The result of the provider
     */
-    void pageChanged(int page);
+    void pageLoaded(qint64 page, const QVariant& data);
+
+protected:
+    void resizeEvent(QResizeEvent* event) override;
+    void changeEvent(QEvent* event) override;
+    bool eventFilter(QObject* watched, QEvent* event) override;
 
 protected slots:
     /**
@@ -64,31 +373,289 @@ protected slots:
 
 private:
     /**
-    * @brief Total number of pages
+    * @brief Switch to the given page, used by all 4 ways of page jumping
+    * @param page The page number
     */
-    int m_pageTotalCount;
+    void moveToPage(qint64 page);
 
     /**
-    * @brief Number of pages to show in the page bar
+    * @brief Go back to page 1 with the given number of pages, shared by setCount and setEstimatedCount
     */
-    int m_pageShowCount;
+    void resetCount(qint64 totalCount, int showCount);
 
     /**
-    * @brief The leftmost (and smallest) page number shown in the widget
+    * @brief Change the number of pages without leaving page, shared by setTotalCount, setEstimate and the > button
     */
-    int m_pageStart;
+    void updateTotalCount(qint64 totalCount);
 
     /**
-    * @brief The currently selected page number
+    * @brief Show the total number of pages in the count label and limit the page number input box to them
     */
-    int m_currentPage;
+    void updateCountLabel();
+
+    /**
+    * @brief Select the current page size in the combo box of setPageSizeOptions, if any
+    */
+    void updatePageSizeBox();
+
+    /**
+    * @brief Move the scrub slider to the current page, unless it is being dragged
+    */
+    void updateScrubSlider();
+
+    /**
+    * @brief The page at a position of the scrub slider
+    */
+    qint64 scrubPage(int value) const;
+
+    /**
+    * @brief Show the page under the handle of the scrub slider in the page buttons, without activating any signal
+    */
+    void previewPage(qint64 page);
+
+    /**
+    * @brief Switch to the previewed page with one setCurrentPage, activating the signals once
+    */
+    void finishScrub();
+
+    /**
+    * @brief Sync the page buttons and the </> buttons with m_window, only the buttons that show another page are relabeled
+    */
+    void updateButtons();
+
+    /**
+    * @brief Make exactly count page buttons visible, reusing the buttons created by earlier setCount calls
+    * @param count Number of page buttons to show
+    */
+    void resizeButtonPool(int count);
+
+    /**
+    * @brief Activate pageChanged with the current page if it differs from the last activation
+    */
+    void commitPage();
+
+    /**
+    * @brief Cancel the running request and request the committed page from the provider
+    */
+    void loadPage();
+
+    /**
+    * @brief Activate keysetRequested for the committed page with the nearest known cursor
+    */
+    void requestKeyset();
+
+    /**
+    * @brief Whether a cursor is known for page, always true outside keyset mode
+    */
+    bool isPageReachable(qint64 page);
+
+    /**
+    * @brief Triggered when the future of the provider has finished
+    */
+    void onPageLoaded();
+
+    /**
+    * @brief Set the page whose button shows the loading state
+    * @param page The page number, 0 for none
+    */
+    void setLoadingPage(qint64 page);
+
+    /**
+    * @brief Mark the page number input box as invalid without blocking, with the "error" property and a tool tip
+    * @param message The error, an empty message clears the error
+    */
+    void setInputError(const QString& message);
+
+    /**
+    * @brief Fit the number of page buttons of m_window to the width in auto mode
+    * @return true if the number of page buttons has changed
+    */
+    bool fitShowCount();
+
+    /**
+    * @brief The number of page buttons that fit into the width, at least 1
+    */
+    int fittedShowCount();
+
+    /**
+    * @brief The width taken by the margins and all widgets except the page buttons
+    */
+    int fixedWidth() const;
+
+    /**
+    * @brief Report the pages to the model, if any
+    */
+    void publishState();
+
+    /**
+    * @brief Apply the newest posted total and page in one batch, queued by the first post after the previous apply
+    */
+    void applyPosted();
+
+    /**
+    * @brief Publish the pages shown by the buttons for snapshot
+    */
+    void updateSnapshot();
+
+    /**
+    * @brief Follow a change of the model made by another bar or through the model, without activating any signal
+    * @param source The bar that made the change, nothing to do if it is this bar
+    */
+    void onModelStateChanged(QObject* source);
+
+    /**
+    * @brief Total pages, the visible window and the current page
+    */
+    PageWindow m_window;
+
+    /**
+    * @brief The font of all widgets in the page bar
+    */
+    QFont m_font;
 
     QLabel* m_countLabel;
     QLineEdit* m_pageLineEdit;
     QPushButton* m_previousButton;
     QPushButton* m_nextButton;
     QPushButton* m_jumpButton;
+
+    /**
+    * @brief Limits the page number input box to 1~totalCount, removed while a key index is set
+    */
+    QPageNumberValidator* m_pageValidator;
+
+    /**
+    * @brief The combo box of setPageSizeOptions, null until it is set
+    */
+    QComboBox* m_pageSizeBox;
+
+    /**
+    * @brief The slider of setScrubSlider, null while it is hidden, and the page under its handle while it is dragged, 0 otherwise.
+    *        The previewed page is only shown in the page buttons, m_window stays on the page before the drag
+    */
+    QSlider* m_scrubSlider;
+    qint64 m_previewPage;
+
+    /**
+    * @brief The page number buttons. Only the first m_window.cellCount() are visible, the rest are kept for reuse
+    */
     QVector<QPushButton*> m_pageButtons;
+
+    /**
+    * @brief The page shown by each button, 0 for an ellipsis and -1 if the button has no label yet
+    */
+    QVector<qint64> m_buttonPages;
+
+    /**
+    * @brief Timers for coalescing, restarted on every page switch and started on the first uncommitted page switch
+    */
+    QTimer* m_quietTimer;
+    QTimer* m_maxDelayTimer;
+
+    /**
+    * @brief The page of the last pageChanged
+    */
+    qint64 m_committedPage;
+
+    QPageProvider* m_pageProvider;
+
+    /**
+    * @brief Watches the future of the running request
+    */
+    QFutureWatcher<QVariant>* m_pageWatcher;
+
+    /**
+    * @brief The page being loaded, 0 if none
+    */
+    qint64 m_loadingPage;
+
+    /**
+    * @brief Number of rows per page, 0 if not set
+    */
+    qint64 m_pageSize;
+
+    /**
+    * @brief The number of rows of setRowCount, -1 if the total was set in pages
+    */
+    qint64 m_rowCount;
+
+    /**
+    * @brief The estimate of setEstimatedCount, 0 if unknown. Only used while the total is open-ended
+    */
+    qint64 m_estimatedCount;
+
+    bool m_keysetMode;
+
+    /**
+    * @brief The first and the last key of each page reported with setPageKeys
+    */
+    QHash<qint64, QPair<QVariant, QVariant>> m_pageKeys;
+
+    QPageKeyIndex* m_keyIndex;
+
+    /**
+    * @brief Nesting depth of beginUpdate, the buttons are only updated at depth 0
+    */
+    int m_updateDepth;
+
+    /**
+    * @brief Measures the latencies while enabled, nullptr otherwise
+    */
+    QPageLatencyTracker* m_latencyTracker;
+
+    /**
+    * @brief Records the navigation while a trace device is set, null otherwise
+    */
+    QScopedPointer<QPageTrace> m_trace;
+
+    QPageBarModel* m_model;
+
+    bool m_autoShowCount;
+
+    /**
+    * @brief The number of page buttons of the last fit, 0 if it needs to be fitted again
+    */
+    int m_fittedShowCount;
+
+    /**
+    * @brief The showCount of setCount and the minimum size without setAutoShowCount, restored when it is turned off
+    */
+    int m_manualShowCount;
+    QSize m_manualMinimumSize;
+
+    /**
+    * @brief The width of a page button with m_cellDigits digits plus the spacing, 0 if it needs to be measured again
+    */
+    int m_cellWidth;
+    int m_cellDigits;
+
+    /**
+    * @brief The newest values of postTotalCount and postCurrentPage, -1 and 0 if none, and whether applyPosted is queued
+    */
+    std::atomic<qint64> m_postedTotalCount;
+    std::atomic<qint64> m_postedPage;
+    std::atomic<bool> m_applyQueued;
+
+    /**
+    * @brief The pages of snapshot, only written in the thread of the page bar. The sequence is odd while they are written
+    */
+    std::atomic<quint32> m_snapshotSequence;
+    std::atomic<qint64> m_snapshotPage;
+    std::atomic<qint64> m_snapshotCount;
+};
+
+/**
+* @brief Calls QPageBar::beginUpdate when constructed and QPageBar::endUpdate when destroyed, like QSignalBlocker
+*/
+class QPageBarUpdateGuard
+{
+public:
+    explicit QPageBarUpdateGuard(QPageBar* pageBar) : m_pageBar(pageBar) { m_pageBar->beginUpdate(); }
+    ~QPageBarUpdateGuard() { m_pageBar->endUpdate(); }
+
+private:
+    Q_DISABLE_COPY(QPageBarUpdateGuard)
+    QPageBar* m_pageBar;
 };
 
 
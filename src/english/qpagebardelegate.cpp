@@ -0,0 +1,199 @@
+#include "qpagebardelegate.h"
+
+#include <QAbstractItemView>
+#include <QApplication>
+#include <QMouseEvent>
+#include <QPainter>
+
+QPageBarDelegate::QPageBarDelegate(QObject* parent) :
+    QStyledItemDelegate(parent),
+    m_showCount(5),
+    m_elided(false),
+    m_hoveredCell(QPageBarPainter::NoCell),
+    m_pressedCell(QPageBarPainter::NoCell)
+{
+}
+
+void QPageBarDelegate::setShowCount(int showCount)
+{
+    m_showCount = showCount;
+}
+
+int QPageBarDelegate::showCount() const
+{
+    return m_showCount;
+}
+
+void QPageBarDelegate::setElided(bool elided)
+{
+    m_elided = elided;
+}
+
+bool QPageBarDelegate::isElided() const
+{
+    return m_elided;
+}
+
+PageWindow QPageBarDelegate::windowFor(const QModelIndex& index) const
+{
+    PageWindow window(index.data(PageCountRole).toLongLong(), m_showCount);
+    window.setElided(m_elided);
+    QVariant start = index.data(WindowStartRole);
+
+    // Without a saved window, place it where paging forward from page 1 would have moved it
+    window.restore(start.isValid() ? start.toLongLong() : 1, index.data(CurrentPageRole).toLongLong());
+    return window;
+}
+
+QPageBarPainter QPageBarDelegate::painterFor(const QModelIndex& index, const QStyleOptionViewItem& option) const
+{
+    QPageBarPainter painter = m_painter;
+    painter.layout(windowFor(index), option.rect.adjusted(3, 0, -3, 0));
+    return painter;
+}
+
+void QPageBarDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    // 1. Draw the background of the cell, including selection, but no text
+    QStyleOptionViewItem itemOption = option;
+    initStyleOption(&itemOption, index);
+    itemOption.text.clear();
+    const QWidget* widget = option.widget;
+    QStyle* style = widget ? widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &itemOption, painter, widget);
+
+    // 2. Draw the page bar, the count label uses the text color of the cell
+    QStyleOption barOption = option;
+    if (option.state & QStyle::State_Selected)
+        barOption.palette.setColor(QPalette::WindowText, option.palette.color(QPalette::HighlightedText));
+    else
+        barOption.palette.setColor(QPalette::WindowText, option.palette.color(QPalette::Text));
+
+    bool hovered = m_hoveredIndex == index;
+    bool pressed = m_pressedIndex == index;
+    painterFor(index, option).paint(painter, barOption, widget,
+                                    hovered ? m_hoveredCell : QPageBarPainter::NoCell,
+                                    pressed ? m_pressedCell : QPageBarPainter::NoCell);
+}
+
+QSize QPageBarDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    Q_UNUSED(option);
+    return m_painter.sizeHint(windowFor(index)) + QSize(6, 4);
+}
+
+bool QPageBarDelegate::editorEvent(QEvent* event, QAbstractItemModel* model, const QStyleOptionViewItem& option, const QModelIndex& index)
+{
+    switch (event->type())
+    {
+    case QEvent::MouseMove:
+    {
+        qint64 cell = painterFor(index, option).cellAt(static_cast<QMouseEvent*>(event)->pos());
+        if (m_hoveredIndex != index || m_hoveredCell != cell)
+        {
+            // The cell that had the hover loses it, eventFilter clears the hover when the mouse leaves the viewport
+            const QAbstractItemView* view = qobject_cast<const QAbstractItemView*>(option.widget);
+            if (m_hoveredIndex != index)
+                clearHover(view);
+            if (view)
+                view->viewport()->installEventFilter(this);
+            m_hoveredIndex = index;
+            m_hoveredCell = cell;
+            updateCell(option);
+        }
+        return false;
+    }
+
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonDblClick:
+    {
+        QMouseEvent* mouseEvent = static_cast<QMouseEvent*>(event);
+        if (mouseEvent->button() != Qt::LeftButton)
+            return false;
+
+        m_pressedIndex = index;
+        m_pressedCell = painterFor(index, option).cellAt(mouseEvent->pos());
+        updateCell(option);
+
+        // Presses outside the page cells still select the row
+        return m_pressedCell != QPageBarPainter::NoCell;
+    }
+
+    case QEvent::MouseButtonRelease:
+    {
+        QMouseEvent* mouseEvent = static_cast<QMouseEvent*>(event);
+        if (mouseEvent->button() != Qt::LeftButton || m_pressedIndex != index || m_pressedCell == QPageBarPainter::NoCell)
+            return false;
+
+        // Like a QPushButton, the cell is only clicked if the mouse is released on the cell where it was pressed
+        qint64 cell = painterFor(index, option).cellAt(mouseEvent->pos());
+        qint64 pressedCell = m_pressedCell;
+        m_pressedIndex = QPersistentModelIndex();
+        m_pressedCell = QPageBarPainter::NoCell;
+        updateCell(option);
+        if (cell != pressedCell)
+            return true;
+
+        // The same window logic as QPageBar::onButtonClicked
+        PageWindow window = windowFor(index);
+        bool changed;
+        switch (cell)
+        {
+        case QPageBarPainter::PreviousCell:
+            changed = window.previous();
+            break;
+
+        case QPageBarPainter::NextCell:
+            changed = window.next();
+            break;
+
+        default: // All other cells are page numbers
+            changed = window.setCurrentPage(cell);
+            break;
+        }
+
+        if (changed)
+        {
+            model->setData(index, window.start(), WindowStartRole);
+            model->setData(index, window.currentPage(), CurrentPageRole);
+            emit pageChanged(index, window.currentPage());
+        }
+        return true;
+    }
+
+    default:
+        return QStyledItemDelegate::editorEvent(event, model, option, index);
+    }
+}
+
+void QPageBarDelegate::updateCell(const QStyleOptionViewItem& option) const
+{
+    const QAbstractItemView* view = qobject_cast<const QAbstractItemView*>(option.widget);
+    if (view)
+        view->viewport()->update(option.rect);
+}
+
+bool QPageBarDelegate::eventFilter(QObject* object, QEvent* event)
+{
+    // The viewports watched by editorEvent, any other object is an editor
+    QAbstractItemView* view = qobject_cast<QAbstractItemView*>(object->parent());
+    if (view == nullptr || object != view->viewport())
+        return QStyledItemDelegate::eventFilter(object, event);
+
+    if (event->type() == QEvent::Leave || event->type() == QEvent::HoverLeave)
+        clearHover(view);
+    else if (event->type() == QEvent::MouseMove && !view->indexAt(static_cast<QMouseEvent*>(event)->pos()).isValid())
+        clearHover(view);
+    return false;
+}
+
+void QPageBarDelegate::clearHover(const QAbstractItemView* view)
+{
+    if (!m_hoveredIndex.isValid())
+        return;
+    QModelIndex index = m_hoveredIndex;
+    m_hoveredIndex = QPersistentModelIndex();
+    m_hoveredCell = QPageBarPainter::NoCell;
+    if (view)
+        view->viewport()->update(view->visualRect(index));
+}
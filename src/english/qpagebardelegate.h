@@ -0,0 +1,115 @@
+#ifndef QPAGEBARDELEGATE_H
+#define QPAGEBARDELEGATE_H
+
+#include <QStyledItemDelegate>
+#include <QPersistentModelIndex>
+
+#include "pagewindow.h"
+#include "qpagebarpainter.h"
+
+class QAbstractItemView;
+
+/**
+* @brief Paints a page bar in every cell of an item view, without creating a widget per cell.
+*        The current page and the total number of pages are read from the model, and clicking a page cell writes the new page back.
+*/
+class QPageBarDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+public:
+    /**
+    * @brief The model roles read and written by the delegate
+    */
+    enum Role
+    {
+        CurrentPageRole = Qt::UserRole + 1,     // The current page, written back when the page changes
+        PageCountRole,                          // The total number of pages
+        WindowStartRole                         // Optional, the leftmost page number shown. Without it the window is placed as if the user had paged forward from page 1
+    };
+
+    explicit QPageBarDelegate(QObject* parent = nullptr);
+
+    /**
+    * @brief Set the number of page buttons shown in each cell
+    * @param showCount Number of page buttons to show
+    */
+    void setShowCount(int showCount);
+    int showCount() const;
+
+    /**
+    * @brief Use the elided layout "1 … 498 499 [500] 501 502 … 1000000" in each cell, see QPageBar::setElided.
+    *        The window is then centered on the current page and WindowStartRole is ignored
+    * @param elided Whether to use the elided layout
+    */
+    void setElided(bool elided);
+    bool isElided() const;
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+signals:
+    /**
+    * @brief This signal will be activated when a page is switched in a cell
+    * @param index The cell
+    * @param page The page number
+    */
+    void pageChanged(const QModelIndex& index, qint64 page);
+
+protected:
+    bool editorEvent(QEvent* event, QAbstractItemModel* model, const QStyleOptionViewItem& option, const QModelIndex& index) override;
+
+    /**
+    * @brief Clear the hover when the mouse leaves the viewport or moves to where there is no cell, editors are handled as usual
+    */
+    bool eventFilter(QObject* object, QEvent* event) override;
+
+private:
+    /**
+    * @brief Build the paging state of a cell from the model data
+    */
+    PageWindow windowFor(const QModelIndex& index) const;
+
+    /**
+    * @brief Lay out the page bar of a cell in option.rect
+    */
+    QPageBarPainter painterFor(const QModelIndex& index, const QStyleOptionViewItem& option) const;
+
+    /**
+    * @brief Repaint a cell of the view that sent an event
+    */
+    void updateCell(const QStyleOptionViewItem& option) const;
+
+    /**
+    * @brief Repaint the cell that has the hover and forget it
+    */
+    void clearHover(const QAbstractItemView* view);
+
+    /**
+    * @brief Number of page buttons shown in each cell
+    */
+    int m_showCount;
+
+    /**
+    * @brief Whether the cells use the elided layout
+    */
+    bool m_elided;
+
+    /**
+    * @brief The font and spacing of all cells, laid out again for each cell
+    */
+    QPageBarPainter m_painter;
+
+    /**
+    * @brief The cell under the mouse and the page cell inside it, hover needs mouse tracking enabled on the view
+    */
+    QPersistentModelIndex m_hoveredIndex;
+    qint64 m_hoveredCell;
+
+    /**
+    * @brief The cell and the page cell inside it on which the left mouse button was pressed
+    */
+    QPersistentModelIndex m_pressedIndex;
+    qint64 m_pressedCell;
+};
+
+#endif // !QPAGEBARDELEGATE_H
@@ -0,0 +1,66 @@
+#include "qpagebarmodel.h"
+
+QPageBarModel::QPageBarModel(QObject* parent) :
+    QObject(parent),
+    m_estimatedCount(0)
+{
+}
+
+const PageWindow& QPageBarModel::window() const
+{
+    return m_window;
+}
+
+qint64 QPageBarModel::estimatedCount() const
+{
+    return m_estimatedCount;
+}
+
+qint64 QPageBarModel::currentPage() const
+{
+    return m_window.currentPage();
+}
+
+qint64 QPageBarModel::pageCount() const
+{
+    return m_window.totalCount();
+}
+
+void QPageBarModel::setCount(qint64 totalCount, int showCount)
+{
+    // Like QPageBar::setCount, going back to page 1 doesn't activate pageChanged
+    m_window.setOpenEnded(false);
+    m_window.setCount(totalCount, showCount);
+    m_estimatedCount = 0;
+    emit stateChanged(nullptr);
+}
+
+void QPageBarModel::setTotalCount(qint64 totalCount)
+{
+    m_window.setOpenEnded(false);
+    m_estimatedCount = 0;
+    bool changed = m_window.setTotalCount(totalCount);
+    emit stateChanged(nullptr);
+    if (changed)
+        emit pageChanged(m_window.currentPage());
+}
+
+void QPageBarModel::setCurrentPage(qint64 page)
+{
+    if (!m_window.setCurrentPage(page))
+        return;
+    emit stateChanged(nullptr);
+    emit pageChanged(page);
+}
+
+void QPageBarModel::setState(const PageWindow& window, qint64 estimatedCount, QObject* source)
+{
+    m_window = window;
+    m_estimatedCount = estimatedCount;
+    emit stateChanged(source);
+}
+
+void QPageBarModel::commitPage(qint64 page)
+{
+    emit pageChanged(page);
+}
@@ -0,0 +1,83 @@
+#ifndef QPAGEBARMODEL_H
+#define QPAGEBARMODEL_H
+
+#include <QObject>
+
+#include "pagewindow.h"
+
+/**
+* @brief The paging state shared by several page bars, e.g. one above and one below a table, see QPageBar::setModel.
+*        A navigation in any of the bars is shown by all of them, and the model activates pageChanged exactly once for it,
+*        so the backend is connected to the model instead of to each bar
+*/
+class QPageBarModel : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QPageBarModel(QObject* parent = nullptr);
+
+    /**
+    * @brief The shared total pages, window and current page. The layout of each bar, e.g. elided or the number of page buttons, is kept by the bar itself
+    */
+    const PageWindow& window() const;
+
+    /**
+    * @brief The estimate of QPageBar::setEstimatedCount, 0 if unknown or if the total is exact
+    */
+    qint64 estimatedCount() const;
+
+    qint64 currentPage() const;
+    qint64 pageCount() const;
+
+    /**
+    * @brief Set the number of pages of all bars from code and go back to page 1, like QPageBar::setCount
+    * @param totalCount Total number of pages
+    * @param showCount Number of page buttons to show
+    */
+    void setCount(qint64 totalCount, int showCount);
+
+    /**
+    * @brief Change only the total number of pages of all bars from code, like QPageBar::setTotalCount
+    * @param totalCount Total number of pages, 0 for none
+    */
+    void setTotalCount(qint64 totalCount);
+
+    /**
+    * @brief Switch all bars to the given page from code, like QPageBar::setCurrentPage
+    * @param page The page number, must be within 1~totalCount
+    */
+    void setCurrentPage(qint64 page);
+
+    /**
+    * @brief Called by a bar whenever its state changes, the other bars follow with stateChanged
+    * @param window The state of the bar
+    * @param estimatedCount The estimate of the bar
+    * @param source The bar, which does not need to follow
+    */
+    void setState(const PageWindow& window, qint64 estimatedCount, QObject* source);
+
+    /**
+    * @brief Called by the bar that made a navigation when it activates its own pageChanged, the other bars stay silent
+    * @param page The page number
+    */
+    void commitPage(qint64 page);
+
+signals:
+    /**
+    * @brief This signal will be activated whenever the shared state changes, the bars use it to follow
+    * @param source The bar that changed the state, nullptr if it was changed through the model
+    */
+    void stateChanged(QObject* source);
+
+    /**
+    * @brief This signal will be activated once per page switch, no matter in which bar or through the model
+    * @param page The page number
+    */
+    void pageChanged(qint64 page);
+
+private:
+    PageWindow m_window;
+    qint64 m_estimatedCount;
+};
+
+#endif // !QPAGEBARMODEL_H
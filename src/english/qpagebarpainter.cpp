@@ -0,0 +1,162 @@
+#include "qpagebarpainter.h"
+
+#include <QApplication>
+#include <QFontMetrics>
+#include <QPainter>
+#include <QStyle>
+#include <QStyleOptionButton>
+
+QPageBarPainter::QPageBarPainter() :
+    m_spacing(3),
+    m_cellStride(0)
+{
+    // Same font as the widgets in QPageBar
+    m_font.setPointSize(10);
+}
+
+void QPageBarPainter::setFont(const QFont& font)
+{
+    m_font = font;
+}
+
+QFont QPageBarPainter::font() const
+{
+    return m_font;
+}
+
+QString QPageBarPainter::countText(const PageWindow& window)
+{
+    return QCoreApplication::translate("QPageBar", "Total pages: ") + QString::number(window.totalCount());
+}
+
+QSize QPageBarPainter::cellSize(const PageWindow& window) const
+{
+    QFontMetrics fontMetrics(m_font);
+
+    // All page cells are as wide as the largest page number, so the cells don't move while paging
+    int textWidth = fontMetrics.horizontalAdvance(QString(QString::number(window.totalCount()).size(), QLatin1Char('0')));
+    int height = fontMetrics.height() + 8;
+    return QSize(qMax(textWidth + 16, height), height);
+}
+
+QSize QPageBarPainter::sizeHint(const PageWindow& window) const
+{
+    QSize cell = cellSize(window);
+    int countWidth = QFontMetrics(m_font).horizontalAdvance(countText(window));
+    return QSize(countWidth + (window.cellCount() + 2) * (cell.width() + m_spacing), cell.height());
+}
+
+void QPageBarPainter::layout(const PageWindow& window, const QRect& rect)
+{
+    m_window = window;
+    m_countText = countText(window);
+
+    QSize cell = cellSize(window);
+    int countWidth = QFontMetrics(m_font).horizontalAdvance(m_countText);
+    int width = countWidth + (window.cellCount() + 2) * (cell.width() + m_spacing);
+
+    // Right-aligned and vertically centered, in the order: count label, <, page cells, >
+    int x = rect.right() + 1 - width;
+    int y = rect.top() + (rect.height() - cell.height()) / 2;
+    m_countRect = QRect(x, rect.top(), countWidth, rect.height());
+    x += countWidth + m_spacing;
+    m_previousRect = QRect(QPoint(x, y), cell);
+    x += cell.width() + m_spacing;
+    m_firstPageRect = QRect(QPoint(x, y), cell);
+    m_cellStride = cell.width() + m_spacing;
+    x += window.cellCount() * m_cellStride;
+    m_nextRect = QRect(QPoint(x, y), cell);
+}
+
+qint64 QPageBarPainter::cellAt(const QPoint& pos) const
+{
+    if (m_window.isEmpty())
+        return NoCell;
+
+    if (m_previousRect.contains(pos))
+        return m_window.canGoPrevious() ? PreviousCell : NoCell;
+    if (m_nextRect.contains(pos))
+        return m_window.canGoNext() ? NextCell : NoCell;
+
+    // The page cells have the same width, so the index is calculated directly
+    if (pos.x() >= m_firstPageRect.left() && pos.y() >= m_firstPageRect.top() && pos.y() <= m_firstPageRect.bottom())
+    {
+        int offset = pos.x() - m_firstPageRect.left();
+        int index = offset / m_cellStride;
+
+        // Clicks on the spacing between two cells are ignored
+        if (index < m_window.cellCount() && offset % m_cellStride < m_firstPageRect.width())
+            return m_window.cellPage(index);
+    }
+    return NoCell;
+}
+
+QRect QPageBarPainter::cellRect(qint64 cell) const
+{
+    switch (cell)
+    {
+    case NoCell:
+        return QRect();
+    case PreviousCell:
+        return m_previousRect;
+    case NextCell:
+        return m_nextRect;
+    default:
+    {
+        int index = m_window.cellOf(cell);
+        if (index < 0)
+            return QRect();
+        return m_firstPageRect.translated(index * m_cellStride, 0);
+    }
+    }
+}
+
+void QPageBarPainter::paint(QPainter* painter, const QStyleOption& option, const QWidget* widget,
+                            qint64 hoveredCell, qint64 pressedCell) const
+{
+    painter->save();
+    painter->setFont(m_font);
+
+    // 1. The count label
+    painter->setPen(option.palette.color(QPalette::WindowText));
+    painter->drawText(m_countRect, Qt::AlignLeft | Qt::AlignVCenter, m_countText);
+
+    // 2. The < button
+    drawCell(painter, option, widget, m_previousRect, QStringLiteral("<"), m_window.canGoPrevious(), false,
+             hoveredCell == PreviousCell, pressedCell == PreviousCell);
+
+    // 3. The page cells, an ellipsis is drawn as a disabled cell
+    for (int i = 0; i < m_window.cellCount(); i++)
+    {
+        qint64 page = m_window.cellPage(i);
+        QString text = page == 0 ? QString(QChar(0x2026)) : QString::number(page);
+        drawCell(painter, option, widget, m_firstPageRect.translated(i * m_cellStride, 0), text, page != 0,
+                 page == m_window.currentPage(), page != 0 && hoveredCell == page, page != 0 && pressedCell == page);
+    }
+
+    // 4. The > button
+    drawCell(painter, option, widget, m_nextRect, QStringLiteral(">"), m_window.canGoNext(), false,
+             hoveredCell == NextCell, pressedCell == NextCell);
+
+    painter->restore();
+}
+
+void QPageBarPainter::drawCell(QPainter* painter, const QStyleOption& option, const QWidget* widget, const QRect& rect,
+                               const QString& text, bool enabled, bool checked, bool hovered, bool pressed) const
+{
+    QStyleOptionButton button;
+    button.direction = option.direction;
+    button.palette = option.palette;
+    button.fontMetrics = QFontMetrics(m_font);
+    button.rect = rect;
+    button.text = text;
+    enabled = enabled && option.state.testFlag(QStyle::State_Enabled);
+    button.state = QStyle::State_Raised;
+    button.state.setFlag(QStyle::State_Enabled, enabled);
+    button.state.setFlag(QStyle::State_MouseOver, enabled && hovered);
+    button.state.setFlag(QStyle::State_Sunken, enabled && pressed);
+    button.state.setFlag(QStyle::State_On, checked);
+
+    QStyle* style = widget ? widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_PushButton, &button, painter, widget);
+}
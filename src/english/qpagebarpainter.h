@@ -0,0 +1,114 @@
+#ifndef QPAGEBARPAINTER_H
+#define QPAGEBARPAINTER_H
+
+#include <QFont>
+#include <QRect>
+#include <QString>
+
+#include "pagewindow.h"
+
+class QPainter;
+class QStyleOption;
+class QWidget;
+
+/**
+* @brief Lays out, paints and hit-tests the count label, the </> buttons and the page buttons of a page bar without creating any widgets.
+*        Used by QPaintedPageBar and QPageBarDelegate. All page cells have the same width, so hit-testing is O(1).
+*/
+class QPageBarPainter
+{
+public:
+    /**
+    * @brief Return values of cellAt() that are not page numbers. Page numbers start at 1, so they never collide
+    */
+    enum Cell
+    {
+        NoCell = 0,
+        PreviousCell = -1,
+        NextCell = -2
+    };
+
+    QPageBarPainter();
+
+    /**
+    * @brief Set the font of the cells and the count label
+    */
+    void setFont(const QFont& font);
+    QFont font() const;
+
+    /**
+    * @brief The text of the count label, translated in the QPageBar context
+    */
+    static QString countText(const PageWindow& window);
+
+    /**
+    * @brief The size needed to show window without squeezing the cells
+    */
+    QSize sizeHint(const PageWindow& window) const;
+
+    /**
+    * @brief Calculate the geometry of all cells. Must be called before cellAt() and paint() whenever window or rect changes
+    * @param window The paging state to show
+    * @param rect The rectangle to lay out in, the cells are right-aligned like in QPageBar
+    */
+    void layout(const PageWindow& window, const QRect& rect);
+
+    /**
+    * @brief Get the cell under pos
+    * @return The page number of a page cell, PreviousCell or NextCell if that button is enabled, otherwise NoCell (also for an ellipsis)
+    */
+    qint64 cellAt(const QPoint& pos) const;
+
+    /**
+    * @brief The rectangle of a cell returned by cellAt(), used to repaint only that cell
+    */
+    QRect cellRect(qint64 cell) const;
+
+    /**
+    * @brief Paint the page bar laid out by layout()
+    * @param painter The painter to use
+    * @param option Provides the state, palette and direction of the cells
+    * @param widget The widget being painted on, can be nullptr
+    * @param hoveredCell The cell under the mouse, drawn as hovered
+    * @param pressedCell The cell being pressed, drawn as sunken
+    */
+    void paint(QPainter* painter, const QStyleOption& option, const QWidget* widget,
+               qint64 hoveredCell = NoCell, qint64 pressedCell = NoCell) const;
+
+private:
+    /**
+    * @brief The size of a single cell, wide enough for the largest page number
+    */
+    QSize cellSize(const PageWindow& window) const;
+
+    /**
+    * @brief Paint a single cell with the style's push button
+    */
+    void drawCell(QPainter* painter, const QStyleOption& option, const QWidget* widget, const QRect& rect,
+                  const QString& text, bool enabled, bool checked, bool hovered, bool pressed) const;
+
+    QFont m_font;
+
+    /**
+    * @brief Space between two cells, the same as the spacing of the QHBoxLayout in QPageBar
+    */
+    int m_spacing;
+
+    /**
+    * @brief The window that was passed to layout()
+    */
+    PageWindow m_window;
+
+    QString m_countText;
+    QRect m_countRect;
+    QRect m_previousRect;
+    QRect m_nextRect;
+
+    /**
+    * @brief The rectangle of the first page cell, the i-th cell is moved right by i * m_cellStride
+    */
+    QRect m_firstPageRect;
+    int m_cellStride;
+};
+
+#endif // !QPAGEBARPAINTER_H
@@ -0,0 +1,185 @@
+#include "qpagecache.h"
+
+#include <QFutureInterface>
+#include <QFutureWatcher>
+
+QPageCache::QPageCache(QPageProvider* source, QObject* parent) :
+    QObject(parent),
+    m_source(source),
+    m_costFunction(&QPageCache::defaultCost),
+    m_prefetchTimer(new QTimer(this)),
+    m_prefetchCenter(0),
+    m_prefetchRadius(1),
+    m_pageCount(0),
+    m_hitCount(0),
+    m_missCount(0),
+    m_generation(0)
+{
+    // 16 MB by default
+    m_cache.setMaxCost(16 * 1024 * 1024);
+
+    m_prefetchTimer->setSingleShot(true);
+    m_prefetchTimer->setInterval(0);
+    connect(m_prefetchTimer, &QTimer::timeout, this, &QPageCache::prefetch);
+}
+
+QFuture<QVariant> QPageCache::requestPage(qint64 page)
+{
+    // Prefetch around the requested page once the event loop is idle
+    m_prefetchCenter = page;
+    if (m_prefetchRadius > 0)
+        m_prefetchTimer->start();
+
+    // 1. The page is cached, return a finished future. object() also marks it as recently used
+    if (QVariant* data = m_cache.object(page))
+    {
+        m_hitCount++;
+        QFutureInterface<QVariant> readyFuture;
+        readyFuture.reportStarted();
+        readyFuture.reportResult(*data);
+        readyFuture.reportFinished();
+        return readyFuture.future();
+    }
+
+    // 2. Every request waits with its own future, a page that is already loading, e.g. by the prefetch, is not loaded again
+    m_missCount++;
+    if (!m_pending.contains(page))
+        fetch(page);
+    QFutureInterface<QVariant> request;
+    request.reportStarted();
+    m_pending[page].requests.append(request);
+    return request.future();
+}
+
+void QPageCache::fetch(qint64 page)
+{
+    QFuture<QVariant> future = m_source->requestPage(page);
+    m_pending.insert(page, PendingPage{ future, {} });
+
+    QFutureWatcher<QVariant>* watcher = new QFutureWatcher<QVariant>(this);
+    int generation = m_generation;
+    connect(watcher, &QFutureWatcher<QVariant>::finished, this, [this, watcher, page, generation]() {
+        QFuture<QVariant> future = watcher->future();
+        watcher->deleteLater();
+
+        // Results loaded before clear() are outdated, clear() has already finished their requests
+        if (generation != m_generation)
+            return;
+        PendingPage pending = m_pending.take(page);
+
+        bool loaded = !future.isCanceled() && future.resultCount() > 0;
+        QVariant data = loaded ? future.result() : QVariant();
+        if (loaded)
+        {
+            // A page larger than the whole budget is not cached, insert deletes it
+            m_cache.insert(page, new QVariant(data), m_costFunction(data));
+        }
+
+        // Cancelled requests finish without a result, a failed load finishes all of them without one
+        for (QFutureInterface<QVariant>& request : pending.requests)
+        {
+            if (loaded && !request.isCanceled())
+                request.reportResult(data);
+            request.reportFinished();
+        }
+    });
+    watcher->setFuture(future);
+}
+
+void QPageCache::prefetch()
+{
+    // Nearer pages first, alternating between after and before the center
+    for (int distance = 1; distance <= m_prefetchRadius; distance++)
+    {
+        for (qint64 page : { m_prefetchCenter + distance, m_prefetchCenter - distance })
+        {
+            if (page < 1 || (m_pageCount > 0 && page > m_pageCount))
+                continue;
+            if (m_cache.contains(page) || m_pending.contains(page))
+                continue;
+            fetch(page);
+        }
+    }
+}
+
+void QPageCache::setPrefetchRadius(int radius)
+{
+    m_prefetchRadius = radius;
+}
+
+int QPageCache::prefetchRadius() const
+{
+    return m_prefetchRadius;
+}
+
+void QPageCache::setPageCount(qint64 pageCount)
+{
+    m_pageCount = pageCount;
+}
+
+void QPageCache::setMaxCost(int bytes)
+{
+    m_cache.setMaxCost(bytes);
+}
+
+int QPageCache::maxCost() const
+{
+    return m_cache.maxCost();
+}
+
+void QPageCache::setCostFunction(const std::function<int(const QVariant&)>& costFunction)
+{
+    m_costFunction = costFunction;
+}
+
+int QPageCache::hitCount() const
+{
+    return m_hitCount;
+}
+
+int QPageCache::missCount() const
+{
+    return m_missCount;
+}
+
+void QPageCache::resetCounters()
+{
+    m_hitCount = 0;
+    m_missCount = 0;
+}
+
+void QPageCache::clear()
+{
+    for (PendingPage& pending : m_pending)
+    {
+        pending.load.cancel();
+        for (QFutureInterface<QVariant>& request : pending.requests)
+        {
+            request.cancel();
+            request.reportFinished();
+        }
+    }
+    m_pending.clear();
+    m_cache.clear();
+    m_generation++;
+}
+
+int QPageCache::defaultCost(const QVariant& data)
+{
+    switch (data.userType())
+    {
+    case QMetaType::QByteArray:
+        return int(data.toByteArray().size());
+    case QMetaType::QString:
+        return int(data.toString().size() * sizeof(QChar));
+    case QMetaType::QVariantList:
+    {
+        int cost = 0;
+        for (const QVariant& item : data.toList())
+            cost += defaultCost(item);
+        return cost;
+    }
+    default:
+        return 1;
+    }
+}
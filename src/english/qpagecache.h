@@ -0,0 +1,120 @@
+#ifndef QPAGECACHE_H
+#define QPAGECACHE_H
+
+#include <QObject>
+#include <QCache>
+#include <QHash>
+#include <QTimer>
+#include <QVector>
+#include <QFutureInterface>
+#include <functional>
+
+#include "qpageprovider.h"
+
+/**
+* @brief A QPageProvider that keeps the loaded pages of another provider in an LRU cache with a byte budget,
+*        and prefetches the neighbouring pages of the requested page when the event loop is idle.
+*        Pass it to QPageBar::setPageProvider instead of the provider it wraps.
+*/
+class QPageCache : public QObject, public QPageProvider
+{
+    Q_OBJECT
+public:
+    /**
+    * @brief Constructor
+    * @param source The provider that actually loads the pages, not owned by the cache
+    */
+    explicit QPageCache(QPageProvider* source, QObject* parent = nullptr);
+
+    /**
+    * @brief Serve the page from the cache, or load it from the source provider. Each request gets its own future,
+    *        so cancelling it only drops this request, the load goes on for the other requests, the prefetch and the cache
+    */
+    QFuture<QVariant> requestPage(qint64 page) override;
+
+    /**
+    * @brief Set how many pages before and after the requested page are prefetched, 0 disables prefetching
+    */
+    void setPrefetchRadius(int radius);
+    int prefetchRadius() const;
+
+    /**
+    * @brief Set the total number of pages, pages after it are not prefetched. 0 means unknown
+    */
+    void setPageCount(qint64 pageCount);
+
+    /**
+    * @brief Set the byte budget of the cache, the least recently used pages are dropped when it is exceeded
+    */
+    void setMaxCost(int bytes);
+    int maxCost() const;
+
+    /**
+    * @brief Set the function that estimates the size of a page in bytes. The default counts the bytes of
+    *        QByteArray, QString and lists of them, and 1 byte for other types
+    */
+    void setCostFunction(const std::function<int(const QVariant&)>& costFunction);
+
+    /**
+    * @brief Number of requestPage calls served from the cache, and number of calls that had to wait for the source
+    */
+    int hitCount() const;
+    int missCount() const;
+    void resetCounters();
+
+    /**
+    * @brief Drop all cached pages, for example after the data has changed. Running loads and the requests waiting for them are cancelled
+    */
+    void clear();
+
+private slots:
+    /**
+    * @brief Load the neighbouring pages of the last requested page that are neither cached nor loading
+    */
+    void prefetch();
+
+private:
+    /**
+    * @brief Load a page from the source provider, when it finishes the result is put into the cache and passed to the waiting requests
+    */
+    void fetch(qint64 page);
+
+    static int defaultCost(const QVariant& data);
+
+    QPageProvider* m_source;
+    QCache<qint64, QVariant> m_cache;
+
+    /**
+    * @brief A page that is being loaded from the source, and the requests waiting for it
+    */
+    struct PendingPage
+    {
+        QFuture<QVariant> load;
+        QVector<QFutureInterface<QVariant>> requests;
+    };
+    QHash<qint64, PendingPage> m_pending;
+
+    std::function<int(const QVariant&)> m_costFunction;
+
+    /**
+    * @brief Single-shot timer with interval 0, so the prefetch runs after all pending events
+    */
+    QTimer* m_prefetchTimer;
+
+    /**
+    * @brief The page around which prefetch() loads pages
+    */
+    qint64 m_prefetchCenter;
+
+    int m_prefetchRadius;
+    qint64 m_pageCount;
+    int m_hitCount;
+    int m_missCount;
+
+    /**
+    * @brief Incremented by clear(), so that running loads don't fill the cleared cache
+    */
+    int m_generation;
+};
+
+#endif // !QPAGECACHE_H
@@ -0,0 +1,94 @@
+#ifndef QPAGEKEYINDEX_H
+#define QPAGEKEYINDEX_H
+
+#include <QMap>
+#include <QVariant>
+#include <functional>
+
+/**
+* @brief A sparse index of page boundary keys for data sorted by a key, e.g. a customer ID or a timestamp.
+*        It finds the page that contains a key by binary search over the pages, so only the first keys of O(log n) pages are fetched,
+*        and the fetched keys are kept for later lookups. See QPageBar::setKeyIndex
+*/
+class QPageKeyIndex
+{
+public:
+    /**
+    * @brief Returns the key of the first row of a page, or an invalid QVariant if it cannot be fetched.
+    *        For example SELECT key FROM table ORDER BY key LIMIT 1 OFFSET (page - 1) * pageSize
+    */
+    using KeyFetcher = std::function<QVariant(qint64 page)>;
+
+    /**
+    * @brief Returns whether the left key sorts before the right key
+    */
+    using LessThan = std::function<bool(const QVariant& left, const QVariant& right)>;
+
+    QPageKeyIndex();
+
+    /**
+    * @brief Constructor
+    * @param fetcher Called for the boundary keys that are not in the index yet
+    */
+    explicit QPageKeyIndex(const KeyFetcher& fetcher);
+
+    void setKeyFetcher(const KeyFetcher& fetcher);
+
+    /**
+    * @brief Set the comparison of keys. The default compares QVariants of the same type, e.g. numbers, strings and date/times
+    */
+    void setLessThan(const LessThan& lessThan);
+
+    /**
+    * @brief Set the total number of pages, QPageBar::jumpToKey keeps it in sync with the page bar
+    */
+    void setPageCount(qint64 pageCount);
+    qint64 pageCount() const;
+
+    /**
+    * @brief Put a known boundary key into the index, e.g. from a page that has just been loaded, so it is not fetched again
+    * @param page The page number
+    * @param firstKey The key of the first row of the page
+    */
+    void setBoundaryKey(qint64 page, const QVariant& firstKey);
+
+    /**
+    * @brief Number of boundary keys in the index
+    */
+    int size() const;
+
+    /**
+    * @brief Forget all boundary keys, e.g. after rows have been inserted or removed
+    */
+    void clear();
+
+    /**
+    * @brief Find the page that contains key, i.e. the last page whose first key is not greater than key.
+    *        If key has another type than the boundary keys, it is converted first, so the text of a line edit can be passed
+    * @param key The key to look up
+    * @return The page number, 1 if key sorts before all rows, or 0 if there are no pages or a boundary key could not be fetched
+    */
+    qint64 pageOf(const QVariant& key);
+
+private:
+    /**
+    * @brief The first key of page, fetched and put into the index if necessary
+    */
+    QVariant boundaryKey(qint64 page);
+
+    /**
+    * @brief Compare two keys of the same type, numbers, dates/times and strings by value
+    */
+    static bool defaultLessThan(const QVariant& left, const QVariant& right);
+
+    KeyFetcher m_fetcher;
+    LessThan m_lessThan;
+    qint64 m_pageCount;
+
+    /**
+    * @brief The known boundary keys by page number
+    */
+    QMap<qint64, QVariant> m_keys;
+};
+
+#endif // !QPAGEKEYINDEX_H
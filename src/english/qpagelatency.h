@@ -0,0 +1,135 @@
+#ifndef QPAGELATENCY_H
+#define QPAGELATENCY_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+
+/**
+* @brief Logs one line per navigation with the latency of every stage, enable it with the rule "qpagebar.latency.debug=true"
+*/
+Q_DECLARE_LOGGING_CATEGORY(lcPageLatency)
+
+/**
+* @brief A histogram of latencies with power-of-two buckets in microseconds. Bucket i counts the latencies
+*        below bucketLimit(i) = 2^i us that did not fit into bucket i - 1, the last bucket counts all longer ones
+*/
+class QPageLatencyHistogram
+{
+public:
+    static constexpr int BucketCount = 32;
+
+    /**
+    * @brief Add a latency
+    * @param nsecs The latency in nanoseconds
+    */
+    void add(qint64 nsecs);
+
+    /**
+    * @brief Number of latencies in bucket index (0 ~ BucketCount - 1)
+    */
+    qint64 bucket(int index) const;
+
+    /**
+    * @brief The exclusive upper limit of bucket index in microseconds
+    */
+    static qint64 bucketLimit(int index);
+
+    /**
+    * @brief The upper limit in microseconds of the bucket that contains the given fraction of all latencies, e.g. 0.99 for p99
+    */
+    qint64 percentile(double fraction) const;
+
+    qint64 count() const;
+    qint64 totalNsecs() const;
+    qint64 maxNsecs() const;
+    void clear();
+
+private:
+    qint64 m_buckets[BucketCount] = {};
+    qint64 m_count = 0;
+    qint64 m_totalNsecs = 0;
+    qint64 m_maxNsecs = 0;
+};
+
+/**
+* @brief Timestamps the stages of each navigation of a QPageBar and collects their latencies, see QPageBar::setLatencyTracking.
+*        A navigation starts with the input, e.g. a click, continues with the activation of pageChanged,
+*        which may be delayed by coalescing, and ends when the consumer reports with QPageBar::pageReady that the page is shown
+*/
+class QPageLatencyTracker : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+    * @brief The measured stages
+    */
+    enum Stage
+    {
+        InputToChanged,     // From the input to the activation of pageChanged, i.e. the widget including coalescing
+        Dispatch,           // The slots connected to pageChanged, i.e. the signal dispatch
+        ChangedToReady,     // From the activation of pageChanged to pageReady, i.e. the backend
+        InputToReady,       // From the input to pageReady, i.e. what the user waits for
+        StageCount
+    };
+    Q_ENUM(Stage)
+
+    explicit QPageLatencyTracker(QObject* parent = nullptr);
+
+    /**
+    * @brief Timestamp the input of a navigation. A later input before pageChanged replaces it, as the user now waits for another page
+    */
+    void markInput();
+
+    /**
+    * @brief Timestamp the activation of pageChanged, called right before it is activated
+    * @param page The page number
+    */
+    void markChanged(qint64 page);
+
+    /**
+    * @brief Timestamp the return of pageChanged, called right after it was activated
+    */
+    void markDispatched();
+
+    /**
+    * @brief Timestamp that the consumer shows page. Ignored unless page is the page of the last pageChanged
+    * @param page The page number
+    */
+    void markReady(qint64 page);
+
+    /**
+    * @brief The latencies of a stage
+    */
+    const QPageLatencyHistogram& histogram(Stage stage) const;
+
+    /**
+    * @brief Clear all histograms
+    */
+    void reset();
+
+private:
+    QElapsedTimer m_clock;
+
+    /**
+    * @brief Timestamps in nanoseconds of m_clock, -1 if not set. m_inputTime is the input waiting for pageChanged,
+    *        m_changedInputTime the input of the navigation waiting for markReady
+    */
+    qint64 m_inputTime;
+    qint64 m_changedTime;
+    qint64 m_changedInputTime;
+
+    /**
+    * @brief The page of the last pageChanged, waiting for markReady. 0 if none
+    */
+    qint64 m_changedPage;
+
+    /**
+    * @brief The dispatch latency of the navigation waiting for markReady, logged together with the other stages. -1 if unknown
+    */
+    qint64 m_dispatchLatency;
+
+    QPageLatencyHistogram m_histograms[StageCount];
+};
+
+#endif // !QPAGELATENCY_H
@@ -0,0 +1,50 @@
+#include "qpagenumbervalidator.h"
+
+QPageNumberValidator::QPageNumberValidator(QObject* parent) :
+    QValidator(parent),
+    m_bottom(1),
+    m_top(0)
+{
+}
+
+void QPageNumberValidator::setRange(qint64 bottom, qint64 top)
+{
+    if (bottom == m_bottom && top == m_top)
+        return;
+    m_bottom = bottom;
+    m_top = top;
+    emit changed();
+}
+
+qint64 QPageNumberValidator::bottom() const
+{
+    return m_bottom;
+}
+
+qint64 QPageNumberValidator::top() const
+{
+    return m_top;
+}
+
+QValidator::State QPageNumberValidator::validate(QString& input, int& pos) const
+{
+    Q_UNUSED(pos);
+
+    // The input may still be cleared and typed again
+    if (input.isEmpty())
+        return Intermediate;
+
+    // Only digits, so that signs, spaces and separators are rejected while typing
+    for (QChar c : input)
+    {
+        if (c < QLatin1Char('0') || c > QLatin1Char('9'))
+            return Invalid;
+    }
+
+    // Numbers that overflow qint64 or exceed the range only get larger with more digits
+    bool isOk;
+    qint64 page = input.toLongLong(&isOk);
+    if (!isOk || page > m_top)
+        return Invalid;
+    return page < m_bottom ? Intermediate : Acceptable;
+}
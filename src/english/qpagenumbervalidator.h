@@ -0,0 +1,32 @@
+#ifndef QPAGENUMBERVALIDATOR_H
+#define QPAGENUMBERVALIDATOR_H
+
+#include <QValidator>
+
+/**
+* @brief Accepts page numbers within a 64-bit range, which QIntValidator cannot hold. Used by the page number input box of QPageBar,
+*        where keystrokes that lead out of the range are rejected at once, and numbers below the range are only intermediate
+*/
+class QPageNumberValidator : public QValidator
+{
+    Q_OBJECT
+public:
+    explicit QPageNumberValidator(QObject* parent = nullptr);
+
+    /**
+    * @brief Set the accepted range, an empty range (top < bottom) only accepts an empty input
+    * @param bottom The smallest page number
+    * @param top The largest page number
+    */
+    void setRange(qint64 bottom, qint64 top);
+    qint64 bottom() const;
+    qint64 top() const;
+
+    State validate(QString& input, int& pos) const override;
+
+private:
+    qint64 m_bottom;
+    qint64 m_top;
+};
+
+#endif // !QPAGENUMBERVALIDATOR_H
@@ -0,0 +1,25 @@
+#ifndef QPAGEPROVIDER_H
+#define QPAGEPROVIDER_H
+
+#include <QFuture>
+#include <QVariant>
+
+/**
+* @brief Loads the content of a page for QPageBar, see QPageBar::setPageProvider.
+*        Implementations start the loading in requestPage and return at once, for example with QtConcurrent::run or a QFutureInterface/QPromise.
+*/
+class QPageProvider
+{
+public:
+    virtual ~QPageProvider() = default;
+
+    /**
+    * @brief Start loading a page. If the page changes again before the future finishes, the future is cancelled and its result is dropped,
+    *        so long-running implementations should check QFuture::isCanceled and stop early
+    * @param page The page number
+    * @return The future of the page content
+    */
+    virtual QFuture<QVariant> requestPage(qint64 page) = 0;
+};
+
+#endif // !QPAGEPROVIDER_H
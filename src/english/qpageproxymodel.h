@@ -0,0 +1,127 @@
+#ifndef QPAGEPROXYMODEL_H
+#define QPAGEPROXYMODEL_H
+
+#include <QAbstractProxyModel>
+#include <QVector>
+
+class QPageBar;
+
+/**
+* @brief Shows only the rows of the current page of a flat source model, e.g. a table or a list, in any view.
+*        Bound to a QPageBar with setPageBar, the bar switches the page and shows the number of pages of the source.
+*        Rows are only fetched up to the end of the current page through canFetchMore/fetchMore, so with a lazy source
+*        like QSqlQueryModel a view never touches more than one page. While the source can fetch more rows, the total is an estimate
+*/
+class QPageProxyModel : public QAbstractProxyModel
+{
+    Q_OBJECT
+public:
+    explicit QPageProxyModel(QObject* parent = nullptr);
+
+    void setSourceModel(QAbstractItemModel* sourceModel) override;
+
+    /**
+    * @brief Set the number of rows per page. The page that contains the first row of the current page becomes current
+    * @param pageSize Number of rows per page, must be greater than 0
+    */
+    void setPageSize(int pageSize);
+    int pageSize() const;
+
+    /**
+    * @brief Switch to the given page, the rows of the view are replaced. Also switches the bound page bar
+    * @param page The page number, within 1~pageCount, or any page after it while the total is an estimate
+    */
+    void setCurrentPage(qint64 page);
+    qint64 currentPage() const;
+
+    /**
+    * @brief The number of pages of the rows fetched from the source so far
+    */
+    qint64 pageCount() const;
+
+    /**
+    * @brief Whether the source has no more rows to fetch, so that pageCount is exact
+    */
+    bool isPageCountExact() const;
+
+    /**
+    * @brief Bind a page bar: its count follows the source, and its page switches switch this model.
+    *        The count is set with setCount, or with setEstimatedCount while the source can fetch more rows
+    * @param pageBar The page bar, not owned by the model. nullptr unbinds it
+    * @param showCount Number of page buttons to show
+    */
+    void setPageBar(QPageBar* pageBar, int showCount = 5);
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex mapToSource(const QModelIndex& proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex& sourceIndex) const override;
+
+    /**
+    * @brief Whether the source can fetch more rows and has not yet fetched all rows of the current page
+    */
+    bool canFetchMore(const QModelIndex& parent) const override;
+
+    /**
+    * @brief Fetch rows from the source until the current page is complete or the source has no more rows
+    */
+    void fetchMore(const QModelIndex& parent) override;
+
+signals:
+    /**
+    * @brief This signal will be activated when the number of pages or whether it is exact changes
+    * @param pageCount The number of pages
+    */
+    void pageCountChanged(qint64 pageCount);
+
+private:
+    /**
+    * @brief The source row of the first row of the current page
+    */
+    qint64 offset() const;
+
+    /**
+    * @brief The number of rows of the current page that the source has fetched
+    */
+    int pageRowCount() const;
+
+    /**
+    * @brief Rebuild the rows of the current page, for all source changes that can't be mapped to single rows
+    */
+    void resetPage();
+
+    /**
+    * @brief Recalculate the number of pages after the source has changed, and report it to the page bar
+    */
+    void updatePageCount();
+
+    /**
+    * @brief Report the number of pages to the page bar
+    */
+    void updatePageBar();
+
+    void onSourceRowsInserted(const QModelIndex& parent, int first, int last);
+    void onSourceRowsRemoved(const QModelIndex& parent, int first, int last);
+    void onSourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles);
+    void onSourceReset();
+
+    int m_pageSize;
+    qint64 m_currentPage;
+
+    /**
+    * @brief The number of rows shown, only changed between the begin and the end of a change notification
+    */
+    int m_rowCount;
+
+    qint64 m_pageCount;
+    bool m_pageCountExact;
+
+    QPageBar* m_pageBar;
+    int m_showCount;
+
+    QVector<QMetaObject::Connection> m_sourceConnections;
+};
+
+#endif // !QPAGEPROXYMODEL_H
@@ -0,0 +1,96 @@
+#ifndef QPAGETRACE_H
+#define QPAGETRACE_H
+
+#include <QDataStream>
+#include <QElapsedTimer>
+
+#include "pagewindow.h"
+
+class QIODevice;
+
+/**
+* @brief A compact binary trace of the navigation of a QPageBar, see QPageBar::setTraceDevice.
+*        The trace starts with a header, followed by one event per navigation: the kind (1 byte),
+*        the microseconds since the previous event (4 bytes) and the page or total (8 bytes), plus the show count (4 bytes) for Count,
+*        EstimatedCount and RowCount events, and the adopted pages (29 bytes) for ModelState events.
+*        Traces are replayed by tools/QPageBarReplay. Version 1 traces only contain the kinds up to Jump
+*/
+class QPageTrace
+{
+public:
+    enum Kind : quint8
+    {
+        Count = 1,          // setCount, value is the total and showCount the number of page buttons
+        TotalCount,         // setTotalCount, value is the total
+        Previous,           // The < button
+        Next,               // The > button
+        Page,               // A page button, value is the page
+        Jump,               // The jump button or jumpToKey, value is the page
+        EstimatedCount,     // setEstimatedCount, value is the estimate and showCount the number of page buttons
+        Estimate,           // setEstimate, value is the estimate
+        RowCount,           // setRowCount, value is the number of rows and showCount the number of page buttons
+        PageSize,           // setPageSize, value is the number of rows per page
+        Elided,             // setElided, value is 1 or 0
+        KeysetMode,         // setKeysetMode, value is 1 or 0
+        ModelState          // Pages adopted from a QPageBarModel, value is the estimate and window the pages
+    };
+
+    struct Event
+    {
+        Kind kind;
+        qint64 usecs;       // Microseconds since the start of the trace
+        qint64 value;
+        qint32 showCount;
+        PageWindow window;  // Only for ModelState
+    };
+
+    /**
+    * @brief Start a trace, the header is written at once
+    * @param device The device to write to, must be open and stays valid while recording
+    */
+    explicit QPageTrace(QIODevice* device);
+
+    /**
+    * @brief Append an event
+    * @param kind The kind of the event
+    * @param value The page or the total, 0 for Previous and Next
+    * @param showCount The number of page buttons, only written for Count, EstimatedCount and RowCount
+    */
+    void record(Kind kind, qint64 value = 0, qint32 showCount = 0);
+
+    /**
+    * @brief Append a ModelState event
+    * @param window The pages of the model: total, show count, window, current page and whether the total is open-ended
+    * @param estimatedCount The estimate of the model
+    */
+    void recordModelState(const PageWindow& window, qint64 estimatedCount);
+
+    /**
+    * @brief Read and check the header of a trace
+    * @return false if the stream does not contain a trace of a supported version, version 1 and 2 are supported
+    */
+    static bool readHeader(QDataStream& stream);
+
+    /**
+    * @brief Read the next event
+    * @param event The event read, its usecs continues from the value it had, so pass the same event for the whole trace
+    * @return false at the end of the trace or on a damaged event
+    */
+    static bool readEvent(QDataStream& stream, Event* event);
+
+private:
+    /**
+    * @brief Write the kind, the time since the previous event and the value
+    */
+    void writeEvent(Kind kind, qint64 value);
+
+    QDataStream m_stream;
+    QElapsedTimer m_clock;
+
+    /**
+    * @brief The time of the last event in microseconds of m_clock
+    */
+    qint64 m_lastUsecs;
+};
+
+#endif // !QPAGETRACE_H
@@ -0,0 +1,203 @@
+#include "qpaintedpagebar.h"
+
+#include <QCursor>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QStyleOption>
+#include <QDebug>
+
+QPaintedPageBar::QPaintedPageBar(QWidget* parent) :
+    QWidget(parent),
+    m_hoveredCell(QPageBarPainter::NoCell),
+    m_pressedCell(QPageBarPainter::NoCell)
+{
+    // Hover effects need mouse move events without a pressed button
+    setMouseTracking(true);
+    setAttribute(Qt::WA_Hover);
+    setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
+
+    // Same margins and font as the QHBoxLayout and widgets in QPageBar
+    setContentsMargins(9, 9, 9, 9);
+
+    QFont font;
+    font.setPointSize(10);
+    setFont(font);
+    m_painter.setFont(font);
+    relayout();
+}
+
+QPaintedPageBar::QPaintedPageBar(qint64 pageTotalCount, int pageShowCount, QWidget* parent) : QPaintedPageBar(parent)
+{
+    setCount(pageTotalCount, pageShowCount);
+}
+
+void QPaintedPageBar::setCount(qint64 totalCount, int showCount)
+{
+    if (showCount <= 0) // if there is no page button to show
+    {
+        qDebug() << "showCount必须大于0"; // showCount must be greater than 0
+        return;
+    }
+
+    m_window.setCount(totalCount, showCount);
+    relayout();
+    updateGeometry();
+}
+
+void QPaintedPageBar::setTotalCount(qint64 totalCount)
+{
+    bool changed = m_window.setTotalCount(totalCount);
+    relayout();
+    updateGeometry();
+    if (changed)
+        emit pageChanged(m_window.currentPage());
+}
+
+void QPaintedPageBar::clear()
+{
+    m_window.clear();
+    relayout();
+    updateGeometry();
+}
+
+qint64 QPaintedPageBar::currentPage()
+{
+    return m_window.currentPage();
+}
+
+void QPaintedPageBar::setCurrentPage(qint64 page)
+{
+    moveToPage(page);
+}
+
+qint64 QPaintedPageBar::pageCount()
+{
+    return m_window.totalCount();
+}
+
+void QPaintedPageBar::setElided(bool elided)
+{
+    m_window.setElided(elided);
+    relayout();
+    updateGeometry();
+}
+
+bool QPaintedPageBar::isElided()
+{
+    return m_window.isElided();
+}
+
+QSize QPaintedPageBar::sizeHint() const
+{
+    QMargins margins = contentsMargins();
+    return m_painter.sizeHint(m_window) + QSize(margins.left() + margins.right(), margins.top() + margins.bottom());
+}
+
+QSize QPaintedPageBar::minimumSizeHint() const
+{
+    return sizeHint();
+}
+
+void QPaintedPageBar::paintEvent(QPaintEvent* event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    QStyleOption option;
+    option.initFrom(this);
+    m_painter.paint(&painter, option, this, m_hoveredCell, m_pressedCell);
+}
+
+void QPaintedPageBar::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    relayout();
+}
+
+void QPaintedPageBar::changeEvent(QEvent* event)
+{
+    QWidget::changeEvent(event);
+    if (event->type() == QEvent::FontChange)
+    {
+        m_painter.setFont(font());
+        relayout();
+        updateGeometry();
+    }
+}
+
+void QPaintedPageBar::mouseMoveEvent(QMouseEvent* event)
+{
+    setHoveredCell(m_painter.cellAt(event->pos()));
+}
+
+void QPaintedPageBar::mousePressEvent(QMouseEvent* event)
+{
+    if (event->button() != Qt::LeftButton)
+        return;
+
+    m_pressedCell = m_painter.cellAt(event->pos());
+    update(m_painter.cellRect(m_pressedCell));
+}
+
+void QPaintedPageBar::mouseReleaseEvent(QMouseEvent* event)
+{
+    if (event->button() != Qt::LeftButton || m_pressedCell == QPageBarPainter::NoCell)
+        return;
+
+    // Like a QPushButton, the cell is only clicked if the mouse is released on the cell where it was pressed
+    qint64 cell = m_painter.cellAt(event->pos());
+    qint64 pressedCell = m_pressedCell;
+    m_pressedCell = QPageBarPainter::NoCell;
+    update(m_painter.cellRect(pressedCell));
+    if (cell != pressedCell)
+        return;
+
+    switch (cell)
+    {
+    case QPageBarPainter::PreviousCell:
+        moveToPage(m_window.currentPage() - 1);
+        break;
+
+    case QPageBarPainter::NextCell:
+        moveToPage(m_window.currentPage() + 1);
+        break;
+
+    default: // All other cells are page numbers
+        moveToPage(cell);
+        break;
+    }
+}
+
+void QPaintedPageBar::leaveEvent(QEvent* event)
+{
+    QWidget::leaveEvent(event);
+    setHoveredCell(QPageBarPainter::NoCell);
+}
+
+void QPaintedPageBar::moveToPage(qint64 page)
+{
+    if (!m_window.setCurrentPage(page))
+        return;
+
+    relayout();
+    emit pageChanged(m_window.currentPage());
+}
+
+void QPaintedPageBar::relayout()
+{
+    m_painter.layout(m_window, contentsRect());
+
+    // The cell under the mouse may show another page now
+    m_hoveredCell = underMouse() ? m_painter.cellAt(mapFromGlobal(QCursor::pos())) : QPageBarPainter::NoCell;
+    update();
+}
+
+void QPaintedPageBar::setHoveredCell(qint64 cell)
+{
+    if (cell == m_hoveredCell)
+        return;
+
+    update(m_painter.cellRect(m_hoveredCell));
+    update(m_painter.cellRect(cell));
+    m_hoveredCell = cell;
+}
@@ -0,0 +1,123 @@
+#ifndef QPAINTEDPAGEBAR_H
+#define QPAINTEDPAGEBAR_H
+
+#include <QWidget>
+
+#include "pagewindow.h"
+#include "qpagebarpainter.h"
+
+/**
+* @brief A lightweight QPageBar that draws the count label, the </> buttons and the page buttons itself instead of using child widgets.
+*        Use it where many page bars are shown at once. It has no page number input box.
+*/
+class QPaintedPageBar : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit QPaintedPageBar(QWidget* parent = nullptr);
+
+    /**
+    * @brief Constructor
+    * @param pageTotalCount Total number of pages
+    * @param pageShowCount Number of page buttons to show
+    */
+    explicit QPaintedPageBar(qint64 pageTotalCount, int pageShowCount = 5, QWidget* parent = nullptr);
+
+    /**
+    * @brief Set the number of pages. showCount is clamped to totalCount and grows back when setTotalCount raises the total
+    * @param totalCount Total number of pages
+    * @param showCount Number of page buttons to show
+    */
+    void setCount(qint64 totalCount, int showCount);
+
+    /**
+    * @brief Change only the total number of pages and keep the current page, see QPageBar::setTotalCount
+    * @param totalCount Total number of pages, 0 for none
+    */
+    void setTotalCount(qint64 totalCount);
+
+    /**
+    * @brief Clear the page buttons and page count
+    */
+    void clear();
+
+    /**
+    * @brief Get the current page number
+    * @return The current page number
+    */
+    qint64 currentPage();
+
+    /**
+    * @brief Switch to the given page from code, e.g. when restoring a view. Activates pageChanged like a click
+    * @param page The page number, must be within 1~totalCount
+    */
+    void setCurrentPage(qint64 page);
+
+    /**
+    * @brief Get the total number of pages
+    * @return The total number of pages
+    */
+    qint64 pageCount();
+
+    /**
+    * @brief Switch to the elided layout "1 … 498 499 [500] 501 502 … 1000000", see QPageBar::setElided
+    * @param elided Whether to use the elided layout
+    */
+    void setElided(bool elided);
+    bool isElided();
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+signals:
+    /**
+    * @brief This signal will be activated when a page is switched
+    * @param page The page number
+    */
+    void pageChanged(qint64 page);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void changeEvent(QEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void leaveEvent(QEvent* event) override;
+
+private:
+    /**
+    * @brief Switch to the given page and repaint
+    * @param page The page number
+    */
+    void moveToPage(qint64 page);
+
+    /**
+    * @brief Recalculate the cell geometry after the window, the size or the font has changed
+    */
+    void relayout();
+
+    /**
+    * @brief Set the cell under the mouse and repaint the cells whose hover state changed
+    */
+    void setHoveredCell(qint64 cell);
+
+    /**
+    * @brief Total pages, the visible window and the current page
+    */
+    PageWindow m_window;
+
+    QPageBarPainter m_painter;
+
+    /**
+    * @brief The cell under the mouse, see QPageBarPainter::cellAt
+    */
+    qint64 m_hoveredCell;
+
+    /**
+    * @brief The cell on which the left mouse button was pressed, it is clicked if the button is also released on it
+    */
+    qint64 m_pressedCell;
+};
+
+#endif // !QPAINTEDPAGEBAR_H
@@ -0,0 +1,256 @@
+#include "qsqlpagesource.h"
+
+#include <QFutureInterface>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QSqlRecord>
+
+#include "qpagebar.h"
+
+QSqlPageSource::QSqlPageSource(const QString& driver, const QString& databaseName, QObject* parent) :
+    QObject(parent),
+    m_worker(new QObject),
+    m_connectionName(QStringLiteral("QSqlPageSource-%1").arg(quintptr(this), 0, 16)),
+    m_driver(driver),
+    m_databaseName(databaseName),
+    m_pageSize(50),
+    m_pageBar(nullptr),
+    m_showCount(5),
+    m_rowCount(-1),
+    m_generation(0)
+{
+    m_worker->moveToThread(&m_thread);
+    m_thread.setObjectName(m_connectionName);
+    m_thread.start();
+}
+
+QSqlPageSource::~QSqlPageSource()
+{
+    // The connection has to be closed in the thread that opened it, after the queued queries
+    QString connectionName = m_connectionName;
+    QMetaObject::invokeMethod(m_worker, [connectionName]() {
+        if (QSqlDatabase::contains(connectionName))
+        {
+            QSqlDatabase::database(connectionName, false).close();
+            QSqlDatabase::removeDatabase(connectionName);
+        }
+    }, Qt::BlockingQueuedConnection);
+    m_thread.quit();
+    m_thread.wait();
+    delete m_worker;
+}
+
+void QSqlPageSource::setConnectionSetup(const std::function<void(QSqlDatabase&)>& setup)
+{
+    m_setup = setup;
+}
+
+void QSqlPageSource::setQuery(const QString& selectSql, const QString& countSql, const QVariantMap& bindValues)
+{
+    m_selectSql = selectSql;
+    m_countSql = countSql;
+    m_bindValues = bindValues;
+    m_rowCount = -1;
+    m_generation++;
+}
+
+void QSqlPageSource::setPageSize(int pageSize)
+{
+    if (pageSize > 0)
+        m_pageSize = pageSize;
+}
+
+int QSqlPageSource::pageSize() const
+{
+    return m_pageSize;
+}
+
+void QSqlPageSource::setPageBar(QPageBar* pageBar, int showCount)
+{
+    if (m_pageBar != nullptr)
+    {
+        m_pageBar->setPageProvider(nullptr);
+        disconnect(m_pageBar, nullptr, this, nullptr);
+    }
+    m_pageBar = pageBar;
+    m_showCount = showCount;
+    if (m_pageBar == nullptr)
+        return;
+
+    m_pageBar->setPageSize(m_pageSize);
+    m_pageBar->setPageProvider(this);
+    connect(m_pageBar, &QPageBar::pageSizeChanged, this, &QSqlPageSource::followPageSize);
+    connect(m_pageBar, &QObject::destroyed, this, [this]() { m_pageBar = nullptr; });
+}
+
+void QSqlPageSource::refresh()
+{
+    // Page 1 is shown at once, the count query is queued after it. Results of the queries before are outdated
+    m_rowCount = -1;
+    m_generation++;
+    if (m_pageBar != nullptr)
+    {
+        m_pageBar->setPageSize(m_pageSize);
+        m_pageBar->setEstimatedCount(0, m_showCount);
+        m_pageBar->reload();
+    }
+    if (!m_countSql.isEmpty())
+        count();
+}
+
+QFuture<QVariant> QSqlPageSource::requestPage(qint64 page)
+{
+    QFutureInterface<QVariant> result;
+    result.reportStarted();
+
+    // 1. The query runs with a copy of the settings, LIMIT and OFFSET are numbers, so they are appended to the SQL
+    QString connectionName = m_connectionName;
+    QString driver = m_driver;
+    QString databaseName = m_databaseName;
+    std::function<void(QSqlDatabase&)> setup = m_setup;
+    QString sql = m_selectSql + QStringLiteral(" LIMIT %1 OFFSET %2").arg(m_pageSize).arg((page - 1) * m_pageSize);
+    QVariantMap bindValues = m_bindValues;
+    int pageSize = m_pageSize;
+    bool findEnd = m_countSql.isEmpty();
+    quint32 generation = m_generation;
+
+    QMetaObject::invokeMethod(m_worker, [=]() mutable {
+        // 2. Pages that were left before their query started are skipped, and so are the queries before a refresh
+        if (result.isCanceled() || generation != m_generation)
+        {
+            result.reportFinished();
+            return;
+        }
+
+        QSqlDatabase db = database(connectionName, driver, databaseName, setup);
+        QSqlQuery query(db);
+        query.prepare(sql);
+        for (auto it = bindValues.constBegin(); it != bindValues.constEnd(); ++it)
+            query.bindValue(it.key(), it.value());
+        if (!query.exec())
+        {
+            // A future without a result is dropped by QPageBar like a failed request
+            QString message = query.lastError().text();
+            result.reportFinished();
+            QMetaObject::invokeMethod(this, [this, message]() { emit errorOccurred(message); }, Qt::QueuedConnection);
+            return;
+        }
+
+        // 3. All rows of the page are collected here and cross to the GUI thread in one batch
+        QVariantList rows;
+        int columnCount = query.record().count();
+        while (query.next())
+        {
+            QVariantList row;
+            row.reserve(columnCount);
+            for (int i = 0; i < columnCount; i++)
+                row.append(query.value(i));
+            rows.append(QVariant(row));
+        }
+
+        // A refresh while the query ran outdates its rows, the future ends without a result
+        if (generation != m_generation)
+        {
+            result.reportFinished();
+            return;
+        }
+        result.reportResult(QVariant(rows));
+        result.reportFinished();
+
+        // 4. Without a count query, a short page is the last one
+        if (findEnd && rows.size() < pageSize)
+        {
+            qint64 rowCount = (page - 1) * pageSize + rows.size();
+            QMetaObject::invokeMethod(this, [this, rowCount, generation]() { setRowCount(rowCount, generation); }, Qt::QueuedConnection);
+        }
+    }, Qt::QueuedConnection);
+
+    return result.future();
+}
+
+void QSqlPageSource::count()
+{
+    QString connectionName = m_connectionName;
+    QString driver = m_driver;
+    QString databaseName = m_databaseName;
+    std::function<void(QSqlDatabase&)> setup = m_setup;
+    QString sql = m_countSql;
+    QVariantMap bindValues = m_bindValues;
+    quint32 generation = m_generation;
+
+    QMetaObject::invokeMethod(m_worker, [=]() {
+        if (generation != m_generation)
+            return;
+
+        QSqlDatabase db = database(connectionName, driver, databaseName, setup);
+        QSqlQuery query(db);
+        query.prepare(sql);
+        for (auto it = bindValues.constBegin(); it != bindValues.constEnd(); ++it)
+            query.bindValue(it.key(), it.value());
+        if (!query.exec() || !query.next())
+        {
+            QString message = query.lastError().text();
+            QMetaObject::invokeMethod(this, [this, message]() { emit errorOccurred(message); }, Qt::QueuedConnection);
+            return;
+        }
+
+        qint64 rowCount = query.value(0).toLongLong();
+        QMetaObject::invokeMethod(this, [this, rowCount, generation]() { setRowCount(rowCount, generation); }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+}
+
+void QSqlPageSource::setRowCount(qint64 rowCount, quint32 generation)
+{
+    // A query that finished after a refresh counted the old rows
+    if (generation != m_generation)
+        return;
+
+    // The total ends the estimated mode of refresh, the current page is kept unless it no longer exists
+    m_rowCount = rowCount;
+    emit rowCountChanged(rowCount);
+    if (m_pageBar != nullptr)
+        m_pageBar->setTotalCount(qMax<qint64>((rowCount + m_pageSize - 1) / m_pageSize, 1));
+}
+
+void QSqlPageSource::followPageSize(qint64 pageSize)
+{
+    // 1. The page size set by this source comes back here and is ignored
+    if (pageSize <= 0 || pageSize == m_pageSize)
+        return;
+    qint64 firstRow = (m_pageBar->currentPage() - 1) * m_pageSize;
+    m_pageSize = int(pageSize);
+
+    // 2. Without the number of rows the pages are unknown, the bar starts again on page 1 like after refresh
+    if (m_rowCount < 0)
+    {
+        m_pageBar->setEstimatedCount(0, m_showCount);
+        m_pageBar->reload();
+        return;
+    }
+
+    // 3. The new total and the page of the first row reach the bar in one batch, the page is loaded again even if its number stays
+    qint64 page = firstRow / m_pageSize + 1;
+    bool samePage = page == m_pageBar->currentPage();
+    m_pageBar->beginUpdate();
+    m_pageBar->setTotalCount(qMax<qint64>((m_rowCount + m_pageSize - 1) / m_pageSize, 1));
+    m_pageBar->setCurrentPage(page);
+    m_pageBar->endUpdate();
+    if (samePage)
+        m_pageBar->reload();
+}
+
+QSqlDatabase QSqlPageSource::database(const QString& connectionName, const QString& driver, const QString& databaseName,
+                                      const std::function<void(QSqlDatabase&)>& setup)
+{
+    // A QSqlDatabase may only be used in the thread that created it, so the connection is created here on first use
+    if (QSqlDatabase::contains(connectionName))
+        return QSqlDatabase::database(connectionName);
+
+    QSqlDatabase db = QSqlDatabase::addDatabase(driver, connectionName);
+    db.setDatabaseName(databaseName);
+    if (setup)
+        setup(db);
+    db.open();
+    return db;
+}
@@ -0,0 +1,145 @@
+#ifndef QSQLPAGESOURCE_H
+#define QSQLPAGESOURCE_H
+
+#include <QObject>
+#include <QThread>
+#include <QVariantMap>
+#include <atomic>
+#include <functional>
+
+#include "qpageprovider.h"
+
+class QPageBar;
+class QSqlDatabase;
+
+/**
+* @brief A QPageProvider that runs LIMIT/OFFSET queries on its own database connection in a worker thread, so slow queries
+*        never block the GUI thread. Each page arrives in one batch as a QVariantList of rows, each row a QVariantList of the columns.
+*        An optional count query runs in the background after the first page and reports the total to the page bar.
+*        Needs QT += sql
+*/
+class QSqlPageSource : public QObject, public QPageProvider
+{
+    Q_OBJECT
+public:
+    /**
+    * @brief Constructor, the connection is opened in the worker thread by the first query
+    * @param driver The Qt SQL driver, e.g. "QSQLITE" or "QPSQL"
+    * @param databaseName The database name, for SQLite the path of the database file
+    */
+    QSqlPageSource(const QString& driver, const QString& databaseName, QObject* parent = nullptr);
+    ~QSqlPageSource() override;
+
+    /**
+    * @brief Set a function that configures the connection before it is opened, e.g. the host name, the user and the password.
+    *        It is called in the worker thread
+    */
+    void setConnectionSetup(const std::function<void(QSqlDatabase&)>& setup);
+
+    /**
+    * @brief Set the queries, used by the following requests
+    * @param selectSql The query of the rows without LIMIT/OFFSET, which are appended for each page, e.g. "SELECT * FROM log ORDER BY id"
+    * @param countSql The query of the number of rows, e.g. "SELECT COUNT(*) FROM log". Empty if counting is too slow,
+    *        then the end is found when a page comes back short
+    * @param bindValues The values of the named placeholders of both queries, e.g. {":level", 3}
+    */
+    void setQuery(const QString& selectSql, const QString& countSql = QString(), const QVariantMap& bindValues = QVariantMap());
+
+    /**
+    * @brief Set the number of rows per page
+    * @param pageSize Number of rows per page, must be greater than 0
+    */
+    void setPageSize(int pageSize);
+    int pageSize() const;
+
+    /**
+    * @brief Load the pages of a page bar: it gets this source as provider and the page size, and refresh updates its count.
+    *        A page size chosen in the bar, e.g. in its page size combo box, becomes the page size of the source
+    * @param pageBar The page bar, not owned by the source. nullptr unbinds it
+    * @param showCount Number of page buttons to show
+    */
+    void setPageBar(QPageBar* pageBar, int showCount = 5);
+
+    /**
+    * @brief Run the queries again, e.g. after setQuery or after the data has changed. The page bar goes back to page 1
+    *        with an unknown total and loads it, then the count query runs in the background. Queries queued before are skipped,
+    *        and the results of queries still running are dropped
+    */
+    void refresh();
+
+    /**
+    * @brief Queue the query of a page in the worker thread. A request that is cancelled before it runs is skipped
+    */
+    QFuture<QVariant> requestPage(qint64 page) override;
+
+signals:
+    /**
+    * @brief This signal will be activated when the number of rows is known, from the count query or from a short page
+    * @param rowCount The number of rows
+    */
+    void rowCountChanged(qint64 rowCount);
+
+    /**
+    * @brief This signal will be activated when the connection can't be opened or a query fails
+    * @param message The error of the driver
+    */
+    void errorOccurred(const QString& message);
+
+private:
+    /**
+    * @brief Queue the count query in the worker thread
+    */
+    void count();
+
+    /**
+    * @brief Report the number of rows to the page bar, in the GUI thread
+    * @param generation The generation of the query, a count of an older generation is dropped
+    */
+    void setRowCount(qint64 rowCount, quint32 generation);
+
+    /**
+    * @brief Follow the page size chosen in the page bar. The page of the first row shown becomes current and is loaded again
+    */
+    void followPageSize(qint64 pageSize);
+
+    /**
+    * @brief The connection of the worker thread, opened on first use. Must only be called in the worker thread
+    */
+    static QSqlDatabase database(const QString& connectionName, const QString& driver, const QString& databaseName,
+                                 const std::function<void(QSqlDatabase&)>& setup);
+
+    QThread m_thread;
+
+    /**
+    * @brief Lives in the worker thread, the queries are queued to it
+    */
+    QObject* m_worker;
+
+    /**
+    * @brief The settings are copied into each query, so the worker thread never reads them
+    */
+    QString m_connectionName;
+    QString m_driver;
+    QString m_databaseName;
+    std::function<void(QSqlDatabase&)> m_setup;
+    QString m_selectSql;
+    QString m_countSql;
+    QVariantMap m_bindValues;
+    int m_pageSize;
+
+    QPageBar* m_pageBar;
+    int m_showCount;
+
+    /**
+    * @brief The number of rows of the query, -1 until the count arrives
+    */
+    qint64 m_rowCount;
+
+    /**
+    * @brief Incremented by setQuery and refresh. Each query carries the generation it was queued in,
+    *        the worker thread skips older ones and the GUI thread drops their counts
+    */
+    std::atomic<quint32> m_generation;
+};
+
+#endif // !QSQLPAGESOURCE_H
@@ -0,0 +1,9 @@
+TEMPLATE = subdirs
+
+# Build with qmake and run all tests with "make check"
+SUBDIRS += \
+    tst_pagebar \
+    tst_pagecache \
+    tst_pageproxymodel \
+    tst_pagewindow \
+    tst_sqlpagesource
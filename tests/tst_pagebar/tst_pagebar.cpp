@@ -0,0 +1,221 @@
+#include <QtTest>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QSlider>
+
+#include "../../src/english/qpagebar.h"
+
+/**
+* @brief The number of visible page buttons, the page buttons are the only checkable buttons of the bar
+*/
+static int pageButtonCount(const QPageBar& bar)
+{
+    int count = 0;
+    for (QPushButton* button : bar.findChildren<QPushButton*>())
+    {
+        if (button->isCheckable() && !button->isHidden())
+            count++;
+    }
+    return count;
+}
+
+/**
+* @brief Tests of the QPageBar widget
+*/
+class TestPageBar : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void setCurrentPageKeyset();
+    void modelKeepsShowCount();
+    void enterReportsInvalidInput();
+    void autoShowCountRestores();
+    void scrubPreview();
+    void pageSizeIgnoresZero();
+    void pageSizeOptionsSetPageSize();
+    void pageSizeKeyset();
+};
+
+void TestPageBar::setCurrentPageKeyset()
+{
+    // Without a cursor keyset mode can't seek to a page, a page set from code is ignored like a disabled button
+    QPageBar bar(100, 5);
+    bar.setKeysetMode(true);
+    QSignalSpy changed(&bar, &QPageBar::pageChanged);
+    QSignalSpy keyset(&bar, &QPageBar::keysetRequested);
+
+    bar.setCurrentPage(50);
+    QCOMPARE(bar.currentPage(), qint64(1));
+    bar.postCurrentPage(50);
+    QCoreApplication::processEvents();
+    QCOMPARE(bar.currentPage(), qint64(1));
+    QCOMPARE(changed.count(), 0);
+    QCOMPARE(keyset.count(), 0);
+
+    // The neighbour of a page with keys can be opened
+    bar.setPageKeys(1, 1, 20);
+    bar.setCurrentPage(2);
+    QCOMPARE(bar.currentPage(), qint64(2));
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(keyset.count(), 1);
+    QCOMPARE(keyset.at(0).at(0).toLongLong(), qint64(2));
+}
+
+void TestPageBar::modelKeepsShowCount()
+{
+    // Bars sharing a model show the same pages, each with its own number of page buttons
+    QPageBarModel model;
+    QPageBar top(100, 5);
+    QPageBar bottom(100, 9);
+    top.setModel(&model);
+    bottom.setModel(&model);
+    QCOMPARE(pageButtonCount(bottom), 9);
+
+    top.setCurrentPage(50);
+    QCOMPARE(bottom.currentPage(), qint64(50));
+    QCOMPARE(pageButtonCount(top), 5);
+    QCOMPARE(pageButtonCount(bottom), 9);
+
+    model.setTotalCount(200);
+    QCOMPARE(top.pageCount(), qint64(200));
+    QCOMPARE(pageButtonCount(top), 5);
+    QCOMPARE(pageButtonCount(bottom), 9);
+}
+
+void TestPageBar::enterReportsInvalidInput()
+{
+    // The validator only accepts 1~totalCount, Enter on anything else has to tell why nothing happens
+    QPageBar bar(100, 5);
+    QLineEdit* lineEdit = bar.findChild<QLineEdit*>();
+    QVERIFY(lineEdit != nullptr);
+
+    QTest::keyClick(lineEdit, Qt::Key_Return);
+    QVERIFY(lineEdit->property("error").toBool());
+    QTest::keyClicks(lineEdit, QStringLiteral("0"));
+    QVERIFY(!lineEdit->property("error").toBool());
+    QTest::keyClick(lineEdit, Qt::Key_Enter);
+    QVERIFY(lineEdit->property("error").toBool());
+    QCOMPARE(bar.currentPage(), qint64(1));
+
+    lineEdit->clear();
+    QTest::keyClicks(lineEdit, QStringLiteral("42"));
+    QTest::keyClick(lineEdit, Qt::Key_Return);
+    QVERIFY(!lineEdit->property("error").toBool());
+    QCOMPARE(bar.currentPage(), qint64(42));
+}
+
+void TestPageBar::autoShowCountRestores()
+{
+    // A narrow bar fits fewer page buttons, turning the mode off brings back the showCount and the minimum size
+    QPageBar bar(100, 7);
+    bar.setMinimumSize(50, 20);
+    bar.resize(120, 30);
+    bar.setAutoShowCount(true);
+    QVERIFY(pageButtonCount(bar) < 7);
+    QCOMPARE(bar.minimumSize(), QSize(0, 0));
+
+    bar.setAutoShowCount(false);
+    QCOMPARE(pageButtonCount(bar), 7);
+    QCOMPARE(bar.minimumSize(), QSize(50, 20));
+
+    // A showCount set while the mode is on is the one restored
+    bar.setAutoShowCount(true);
+    bar.setCount(100, 9);
+    bar.setAutoShowCount(false);
+    QCOMPARE(pageButtonCount(bar), 9);
+}
+
+void TestPageBar::scrubPreview()
+{
+    // Dragging only shows the page under the handle in the buttons, the release switches to it once
+    QPageBar bar(100, 5);
+    bar.setScrubSlider(true);
+    QSlider* slider = bar.findChild<QSlider*>();
+    QVERIFY(slider != nullptr);
+    QSignalSpy requested(&bar, &QPageBar::pageRequested);
+    QSignalSpy changed(&bar, &QPageBar::pageChanged);
+
+    slider->setSliderDown(true);
+    slider->setValue(29);
+    slider->setValue(49);
+    QCOMPARE(bar.currentPage(), qint64(1));
+    QCOMPARE(bar.snapshot().currentPage, qint64(1));
+    QCOMPARE(requested.count(), 0);
+    QCOMPARE(changed.count(), 0);
+    QPushButton* checked = nullptr;
+    for (QPushButton* button : bar.findChildren<QPushButton*>())
+    {
+        if (button->isCheckable() && !button->isHidden() && button->isChecked())
+            checked = button;
+    }
+    QVERIFY(checked != nullptr);
+    QCOMPARE(checked->text(), QStringLiteral("50"));
+
+    slider->setSliderDown(false);
+    QCOMPARE(bar.currentPage(), qint64(50));
+    QCOMPARE(requested.count(), 1);
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(changed.at(0).at(0).toLongLong(), qint64(50));
+}
+
+void TestPageBar::pageSizeIgnoresZero()
+{
+    // A page size that is not positive is ignored like a showCount of 0, the pages are kept
+    QPageBar bar;
+    bar.setPageSize(50);
+    bar.setRowCount(1000, 5);
+    QSignalSpy sizeChanged(&bar, &QPageBar::pageSizeChanged);
+
+    bar.setPageSize(0);
+    bar.setPageSize(-10);
+    QCOMPARE(bar.pageSize(), qint64(50));
+    QCOMPARE(bar.pageCount(), qint64(20));
+    QCOMPARE(sizeChanged.count(), 0);
+}
+
+void TestPageBar::pageSizeOptionsSetPageSize()
+{
+    // The first option becomes the page size like a choice in the combo box, an existing page size is kept
+    QPageBar bar(10, 5);
+    QSignalSpy sizeChanged(&bar, &QPageBar::pageSizeChanged);
+    bar.setPageSizeOptions({ 25, 50, 100 });
+    QCOMPARE(bar.pageSize(), qint64(25));
+    QCOMPARE(sizeChanged.count(), 1);
+    QCOMPARE(sizeChanged.at(0).at(0).toLongLong(), qint64(25));
+
+    bar.setPageSizeOptions({ 10, 20 });
+    QCOMPARE(bar.pageSize(), qint64(25));
+    QCOMPARE(sizeChanged.count(), 1);
+}
+
+void TestPageBar::pageSizeKeyset()
+{
+    // The keys of the old page size don't mark the new pages, keyset mode seeks page 1 from the start
+    QPageBar bar;
+    bar.setPageSize(10);
+    bar.setRowCount(1000, 5);
+    bar.setKeysetMode(true);
+    bar.setPageKeys(1, 1, 10);
+    bar.setCurrentPage(2);
+    bar.setPageKeys(2, 11, 20);
+    bar.setCurrentPage(3);
+    QCOMPARE(bar.currentPage(), qint64(3));
+    QSignalSpy keyset(&bar, &QPageBar::keysetRequested);
+
+    bar.setPageSize(20);
+    QCOMPARE(bar.currentPage(), qint64(1));
+    QCOMPARE(bar.pageCount(), qint64(50));
+    QCOMPARE(keyset.count(), 1);
+    QCOMPARE(keyset.at(0).at(0).toLongLong(), qint64(1));
+    QVERIFY(!keyset.at(0).at(1).isValid());
+    QCOMPARE(keyset.at(0).at(2).value<QPageBar::KeysetSeek>(), QPageBar::SeekFrom);
+
+    // Page 2 has no cursor until the keys of page 1 are reported again
+    bar.setCurrentPage(2);
+    QCOMPARE(bar.currentPage(), qint64(1));
+}
+
+QTEST_MAIN(TestPageBar)
+
+#include "tst_pagebar.moc"
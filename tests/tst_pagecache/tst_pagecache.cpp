@@ -0,0 +1,127 @@
+#include <QtTest>
+#include <QFutureInterface>
+
+#include "../../src/english/qpagecache.h"
+
+/**
+* @brief A provider whose pages only finish when the test says so
+*/
+class ManualProvider : public QPageProvider
+{
+public:
+    QFuture<QVariant> requestPage(qint64 page) override
+    {
+        QFutureInterface<QVariant> request;
+        request.reportStarted();
+        m_requests.insert(page, request);
+        m_loadCounts[page]++;
+        return request.future();
+    }
+
+    void finish(qint64 page, const QVariant& data)
+    {
+        QFutureInterface<QVariant> request = m_requests.take(page);
+        request.reportResult(data);
+        request.reportFinished();
+    }
+
+    int loadCount(qint64 page) const
+    {
+        return m_loadCounts.value(page);
+    }
+
+private:
+    QHash<qint64, QFutureInterface<QVariant>> m_requests;
+    QHash<qint64, int> m_loadCounts;
+};
+
+/**
+* @brief Tests of QPageCache
+*/
+class TestPageCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cancelThenRequestAgain();
+    void cancelDoesNotCancelOtherRequests();
+    void cachedPage();
+    void prefetchIsShared();
+};
+
+void TestPageCache::cancelThenRequestAgain()
+{
+    // QPageBar cancels the request of a page it leaves, coming back to the page must still load it
+    ManualProvider source;
+    QPageCache cache(&source);
+    cache.setPrefetchRadius(0);
+
+    QFuture<QVariant> first = cache.requestPage(3);
+    first.cancel();
+    QFuture<QVariant> second = cache.requestPage(3);
+    QVERIFY(!second.isCanceled());
+
+    source.finish(3, QStringLiteral("page 3"));
+    QTRY_VERIFY(second.isFinished());
+    QCOMPARE(second.resultCount(), 1);
+    QCOMPARE(second.result(), QVariant(QStringLiteral("page 3")));
+    QCOMPARE(first.resultCount(), 0);
+
+    // Both requests shared one load
+    QCOMPARE(source.loadCount(3), 1);
+}
+
+void TestPageCache::cancelDoesNotCancelOtherRequests()
+{
+    ManualProvider source;
+    QPageCache cache(&source);
+    cache.setPrefetchRadius(0);
+
+    QFuture<QVariant> first = cache.requestPage(5);
+    QFuture<QVariant> second = cache.requestPage(5);
+    second.cancel();
+
+    source.finish(5, QStringLiteral("page 5"));
+    QTRY_VERIFY(first.isFinished());
+    QCOMPARE(first.result(), QVariant(QStringLiteral("page 5")));
+}
+
+void TestPageCache::cachedPage()
+{
+    // A page is cached even if its only request was cancelled
+    ManualProvider source;
+    QPageCache cache(&source);
+    cache.setPrefetchRadius(0);
+
+    QFuture<QVariant> request = cache.requestPage(2);
+    request.cancel();
+    source.finish(2, QStringLiteral("page 2"));
+    QTRY_VERIFY(request.isFinished());
+
+    QFuture<QVariant> cached = cache.requestPage(2);
+    QVERIFY(cached.isFinished());
+    QCOMPARE(cached.result(), QVariant(QStringLiteral("page 2")));
+    QCOMPARE(cache.hitCount(), 1);
+    QCOMPARE(source.loadCount(2), 1);
+}
+
+void TestPageCache::prefetchIsShared()
+{
+    // The neighbour is prefetched once the event loop is idle, a request for it waits for the same load
+    ManualProvider source;
+    QPageCache cache(&source);
+    cache.setPrefetchRadius(1);
+    cache.setPageCount(10);
+
+    cache.requestPage(1);
+    QTRY_COMPARE(source.loadCount(2), 1);
+    QFuture<QVariant> next = cache.requestPage(2);
+    source.finish(2, QStringLiteral("page 2"));
+    QTRY_VERIFY(next.isFinished());
+    QCOMPARE(next.result(), QVariant(QStringLiteral("page 2")));
+    QCOMPARE(source.loadCount(2), 1);
+}
+
+QTEST_GUILESS_MAIN(TestPageCache)
+
+#include "tst_pagecache.moc"
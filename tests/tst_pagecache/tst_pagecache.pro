@@ -0,0 +1,13 @@
+QT       += testlib
+QT       -= gui
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+SOURCES += \
+    tst_pagecache.cpp \
+    ../../src/english/qpagecache.cpp
+
+HEADERS += \
+    ../../src/english/qpagecache.h \
+    ../../src/english/qpageprovider.h
@@ -0,0 +1,83 @@
+#include <QtTest>
+#include <QPushButton>
+#include <QStandardItemModel>
+
+#include "../../src/english/qpageproxymodel.h"
+#include "../../src/english/qpagebar.h"
+
+/**
+* @brief The number of visible page buttons, the page buttons are the only checkable buttons of the bar
+*/
+static int pageButtonCount(const QPageBar& bar)
+{
+    int count = 0;
+    for (QPushButton* button : bar.findChildren<QPushButton*>())
+    {
+        if (button->isCheckable() && !button->isHidden())
+            count++;
+    }
+    return count;
+}
+
+/**
+* @brief Appends rows with their row number as text
+*/
+static void appendRows(QStandardItemModel* model, int count)
+{
+    for (int i = 0; i < count; i++)
+        model->appendRow(new QStandardItem(QString::number(model->rowCount())));
+}
+
+/**
+* @brief Tests of QPageProxyModel together with its page bar
+*/
+class TestPageProxyModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void pageBarBeforeSource();
+    void pageBarSwitchesPage();
+};
+
+void TestPageProxyModel::pageBarBeforeSource()
+{
+    // The bar is bound while there are no pages yet, the page buttons appear as the rows arrive
+    QStandardItemModel source;
+    QPageProxyModel proxy;
+    QPageBar bar;
+    proxy.setPageSize(10);
+    proxy.setPageBar(&bar, 5);
+    proxy.setSourceModel(&source);
+    QCOMPARE(bar.pageCount(), qint64(0));
+
+    appendRows(&source, 35);
+    QCOMPARE(bar.pageCount(), qint64(4));
+    QCOMPARE(pageButtonCount(bar), 4);
+
+    appendRows(&source, 65);
+    QCOMPARE(bar.pageCount(), qint64(10));
+    QCOMPARE(pageButtonCount(bar), 5);
+    QCOMPARE(proxy.rowCount(), 10);
+}
+
+void TestPageProxyModel::pageBarSwitchesPage()
+{
+    QStandardItemModel source;
+    appendRows(&source, 25);
+    QPageProxyModel proxy;
+    QPageBar bar;
+    proxy.setSourceModel(&source);
+    proxy.setPageSize(10);
+    proxy.setPageBar(&bar, 5);
+    QCOMPARE(pageButtonCount(bar), 3);
+
+    bar.setCurrentPage(3);
+    QCOMPARE(proxy.currentPage(), qint64(3));
+    QCOMPARE(proxy.rowCount(), 5);
+    QCOMPARE(proxy.index(0, 0).data().toString(), QStringLiteral("20"));
+}
+
+QTEST_MAIN(TestPageProxyModel)
+
+#include "tst_pageproxymodel.moc"
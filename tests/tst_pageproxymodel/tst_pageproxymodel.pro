@@ -0,0 +1,26 @@
+QT       += testlib widgets
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+# Runs without a display with QT_QPA_PLATFORM=offscreen
+SOURCES += \
+    tst_pageproxymodel.cpp \
+    ../../src/english/qpageproxymodel.cpp \
+    ../../src/english/qpagebar.cpp \
+    ../../src/english/qpagekeyindex.cpp \
+    ../../src/english/qpagelatency.cpp \
+    ../../src/english/qpagetrace.cpp \
+    ../../src/english/qpagebarmodel.cpp \
+    ../../src/english/qpagenumbervalidator.cpp
+
+HEADERS += \
+    ../../src/english/qpageproxymodel.h \
+    ../../src/english/qpagebar.h \
+    ../../src/english/pagewindow.h \
+    ../../src/english/qpageprovider.h \
+    ../../src/english/qpagekeyindex.h \
+    ../../src/english/qpagelatency.h \
+    ../../src/english/qpagetrace.h \
+    ../../src/english/qpagebarmodel.h \
+    ../../src/english/qpagenumbervalidator.h
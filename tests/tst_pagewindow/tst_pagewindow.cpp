@@ -0,0 +1,191 @@
+#include <QtTest>
+
+#include "../../src/english/pagewindow.h"
+
+/**
+* @brief Tests of the paging logic of PageWindow, which needs no QApplication
+*/
+class TestPageWindow : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void setCount();
+    void setCountClampsShowCount();
+    void setCountEmpty();
+    void setCurrentPage();
+    void setTotalCountKeepsPage();
+    void setTotalCountShrinksAndGrows();
+    void setTotalCountFromEmpty();
+    void restore();
+    void elided();
+    void elidedEdges();
+    void openEndedNext();
+};
+
+void TestPageWindow::setCount()
+{
+    PageWindow window(100, 5);
+    QCOMPARE(window.totalCount(), qint64(100));
+    QCOMPARE(window.showCount(), 5);
+    QCOMPARE(window.currentPage(), qint64(1));
+    QCOMPARE(window.start(), qint64(1));
+    QCOMPARE(window.cellCount(), 5);
+    for (int i = 0; i < window.cellCount(); i++)
+        QCOMPARE(window.cellPage(i), qint64(i + 1));
+    QVERIFY(!window.canGoPrevious());
+    QVERIFY(window.canGoNext());
+}
+
+void TestPageWindow::setCountClampsShowCount()
+{
+    PageWindow window(3, 5);
+    QCOMPARE(window.showCount(), 3);
+    QCOMPARE(window.end(), qint64(3));
+}
+
+void TestPageWindow::setCountEmpty()
+{
+    PageWindow window(0, 5);
+    QVERIFY(window.isEmpty());
+    QCOMPARE(window.cellCount(), 0);
+    QVERIFY(!window.canGoPrevious());
+    QVERIFY(!window.canGoNext());
+    QVERIFY(!window.setCurrentPage(1));
+}
+
+void TestPageWindow::setCurrentPage()
+{
+    // The window shifts as little as possible, so the page becomes the last or the first button
+    PageWindow window(100, 5);
+    QVERIFY(window.setCurrentPage(7));
+    QCOMPARE(window.start(), qint64(3));
+    QCOMPARE(window.indexOf(7), 4);
+    QVERIFY(window.setCurrentPage(2));
+    QCOMPARE(window.start(), qint64(2));
+    QVERIFY(!window.setCurrentPage(2));
+    QVERIFY(!window.setCurrentPage(0));
+    QVERIFY(!window.setCurrentPage(101));
+    QCOMPARE(window.currentPage(), qint64(2));
+}
+
+void TestPageWindow::setTotalCountKeepsPage()
+{
+    PageWindow window(100, 5);
+    window.setCurrentPage(50);
+    QVERIFY(!window.setTotalCount(200));
+    QCOMPARE(window.currentPage(), qint64(50));
+    QCOMPARE(window.start(), qint64(46));
+
+    // The current page is gone, the last page becomes current
+    QVERIFY(window.setTotalCount(20));
+    QCOMPARE(window.currentPage(), qint64(20));
+    QCOMPARE(window.end(), qint64(20));
+}
+
+void TestPageWindow::setTotalCountShrinksAndGrows()
+{
+    // The page buttons follow a shrinking total and come back up to the showCount of setCount
+    PageWindow window(100, 5);
+    window.setTotalCount(2);
+    QCOMPARE(window.showCount(), 2);
+    window.setTotalCount(0);
+    QVERIFY(window.isEmpty());
+    QCOMPARE(window.showCount(), 0);
+    window.setTotalCount(50);
+    QCOMPARE(window.showCount(), 5);
+    QCOMPARE(window.currentPage(), qint64(1));
+}
+
+void TestPageWindow::setTotalCountFromEmpty()
+{
+    // A window started without pages, or cleared, keeps its showCount for the pages that arrive later
+    PageWindow window(0, 5);
+    QVERIFY(window.isEmpty());
+    window.setTotalCount(3);
+    QCOMPARE(window.showCount(), 3);
+    window.setTotalCount(50);
+    QCOMPARE(window.showCount(), 5);
+    QCOMPARE(window.cellCount(), 5);
+
+    window.clear();
+    QVERIFY(window.isEmpty());
+    window.setTotalCount(10);
+    QCOMPARE(window.showCount(), 5);
+    QCOMPARE(window.end(), qint64(5));
+}
+
+void TestPageWindow::restore()
+{
+    PageWindow window(100, 5);
+    window.restore(40, 42);
+    QCOMPARE(window.start(), qint64(40));
+    QCOMPARE(window.currentPage(), qint64(42));
+
+    // Both are clamped, the current page stays visible
+    window.restore(1, 42);
+    QCOMPARE(window.start(), qint64(38));
+    window.restore(99, 500);
+    QCOMPARE(window.currentPage(), qint64(100));
+    QCOMPARE(window.start(), qint64(96));
+}
+
+void TestPageWindow::elided()
+{
+    // "1 … 498 499 [500] 501 502 … 1000"
+    PageWindow window(1000, 5);
+    window.setElided(true);
+    window.setCurrentPage(500);
+    QVERIFY(window.hasEllipses());
+    QCOMPARE(window.cellCount(), 9);
+    const qint64 pages[] = { 1, 0, 498, 499, 500, 501, 502, 0, 1000 };
+    for (int i = 0; i < window.cellCount(); i++)
+        QCOMPARE(window.cellPage(i), pages[i]);
+    QCOMPARE(window.cellOf(500), 4);
+    QCOMPARE(window.cellOf(1000), 8);
+    QCOMPARE(window.cellOf(2), -1);
+}
+
+void TestPageWindow::elidedEdges()
+{
+    // Near the first page, page 2 takes the place of the ellipsis
+    PageWindow window(1000, 5);
+    window.setElided(true);
+    QCOMPARE(window.cellPage(1), qint64(2));
+    QCOMPARE(window.cellPage(2), qint64(3));
+    QCOMPARE(window.cellPage(7), qint64(0));
+
+    // Near the last page, page 999 does
+    window.setCurrentPage(1000);
+    QCOMPARE(window.cellPage(7), qint64(999));
+    QCOMPARE(window.cellPage(1), qint64(0));
+
+    // Few pages need no ellipses
+    PageWindow small(7, 5);
+    small.setElided(true);
+    QVERIFY(!small.hasEllipses());
+    QCOMPARE(small.cellCount(), 7);
+    QCOMPARE(small.cellPage(6), qint64(7));
+}
+
+void TestPageWindow::openEndedNext()
+{
+    // Past the end of an open-ended total the next page is assumed to exist
+    PageWindow window(3, 5);
+    window.setOpenEnded(true);
+    window.setCurrentPage(3);
+    QVERIFY(window.canGoNext());
+    QVERIFY(window.next());
+    QCOMPARE(window.totalCount(), qint64(4));
+    QCOMPARE(window.currentPage(), qint64(4));
+    QCOMPARE(window.showCount(), 4);
+
+    // An exact total stops at the last page
+    window.setOpenEnded(false);
+    QVERIFY(!window.canGoNext());
+    QVERIFY(!window.next());
+}
+
+QTEST_APPLESS_MAIN(TestPageWindow)
+
+#include "tst_pagewindow.moc"
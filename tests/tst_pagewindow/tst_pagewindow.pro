@@ -0,0 +1,11 @@
+QT       += testlib
+QT       -= gui
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+SOURCES += \
+    tst_pagewindow.cpp
+
+HEADERS += \
+    ../../src/english/pagewindow.h
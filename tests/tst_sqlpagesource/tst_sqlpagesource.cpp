@@ -0,0 +1,134 @@
+#include <QtTest>
+#include <QSemaphore>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+
+#include "../../src/english/qpagebar.h"
+#include "../../src/english/qsqlpagesource.h"
+
+/**
+* @brief Tests of QSqlPageSource on a SQLite file with the ids 1~120
+*/
+class TestSqlPageSource : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void requestPage();
+    void refreshDropsStaleCount();
+    void refreshDropsStalePage();
+    void pageBarPageSize();
+
+private:
+    QTemporaryDir m_dir;
+    QString m_databaseName;
+};
+
+void TestSqlPageSource::initTestCase()
+{
+    if (!QSqlDatabase::isDriverAvailable(QStringLiteral("QSQLITE")))
+        QSKIP("The QSQLITE driver is not available");
+    QVERIFY(m_dir.isValid());
+    m_databaseName = m_dir.filePath(QStringLiteral("log.db"));
+
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), QStringLiteral("fill"));
+        db.setDatabaseName(m_databaseName);
+        QVERIFY(db.open());
+        QSqlQuery query(db);
+        QVERIFY(query.exec(QStringLiteral("CREATE TABLE log (id INTEGER PRIMARY KEY)")));
+        db.transaction();
+        for (int id = 1; id <= 120; id++)
+            QVERIFY(query.exec(QStringLiteral("INSERT INTO log (id) VALUES (%1)").arg(id)));
+        db.commit();
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(QStringLiteral("fill"));
+}
+
+void TestSqlPageSource::requestPage()
+{
+    QSqlPageSource source(QStringLiteral("QSQLITE"), m_databaseName);
+    source.setQuery(QStringLiteral("SELECT id FROM log ORDER BY id"));
+    source.setPageSize(50);
+
+    // The last page is short
+    QFuture<QVariant> page = source.requestPage(3);
+    QTRY_VERIFY(page.isFinished());
+    QCOMPARE(page.resultCount(), 1);
+    QVariantList rows = page.result().toList();
+    QCOMPARE(rows.size(), 20);
+    QCOMPARE(rows.first().toList().first().toLongLong(), qint64(101));
+}
+
+void TestSqlPageSource::refreshDropsStaleCount()
+{
+    // The count of the first query arrives after the second refresh, only the count of the second query is reported
+    QSqlPageSource source(QStringLiteral("QSQLITE"), m_databaseName);
+    QSignalSpy rowCounts(&source, &QSqlPageSource::rowCountChanged);
+    source.setQuery(QStringLiteral("SELECT id FROM log ORDER BY id"), QStringLiteral("SELECT COUNT(*) FROM log"));
+    source.refresh();
+    source.setQuery(QStringLiteral("SELECT id FROM log WHERE id <= 10 ORDER BY id"), QStringLiteral("SELECT COUNT(*) FROM log WHERE id <= 10"));
+    source.refresh();
+
+    QTRY_COMPARE(rowCounts.count(), 1);
+    QCOMPARE(rowCounts.at(0).at(0).toLongLong(), qint64(10));
+    QTest::qWait(50);
+    QCOMPARE(rowCounts.count(), 1);
+}
+
+void TestSqlPageSource::refreshDropsStalePage()
+{
+    // The connection setup holds the worker thread inside the first query until the refresh has happened
+    QSemaphore gate;
+    QSqlPageSource source(QStringLiteral("QSQLITE"), m_databaseName);
+    source.setConnectionSetup([&gate](QSqlDatabase&) { gate.acquire(); });
+    source.setQuery(QStringLiteral("SELECT id FROM log ORDER BY id"));
+    source.setPageSize(50);
+
+    QFuture<QVariant> stale = source.requestPage(1);
+    source.refresh();
+    gate.release();
+    QTRY_VERIFY(stale.isFinished());
+    QCOMPARE(stale.resultCount(), 0);
+
+    QFuture<QVariant> fresh = source.requestPage(1);
+    QTRY_VERIFY(fresh.isFinished());
+    QCOMPARE(fresh.resultCount(), 1);
+}
+
+void TestSqlPageSource::pageBarPageSize()
+{
+    // A page size chosen in the bar is used by the queries, the page of the first row shown is loaded with it
+    QSqlPageSource source(QStringLiteral("QSQLITE"), m_databaseName);
+    source.setQuery(QStringLiteral("SELECT id FROM log ORDER BY id"), QStringLiteral("SELECT COUNT(*) FROM log"));
+    source.setPageSize(20);
+    QPageBar bar;
+    source.setPageBar(&bar);
+    source.refresh();
+    QTRY_COMPARE(bar.pageCount(), qint64(6));
+    bar.setCurrentPage(4);
+
+    // Rows 61~80 were shown, with 50 rows per page row 61 is on page 2
+    QSignalSpy loaded(&bar, &QPageBar::pageLoaded);
+    bar.setPageSize(50);
+    QCOMPARE(source.pageSize(), 50);
+    QCOMPARE(bar.pageCount(), qint64(3));
+    QCOMPARE(bar.currentPage(), qint64(2));
+    QTRY_VERIFY(!loaded.isEmpty());
+    QCOMPARE(loaded.last().at(0).toLongLong(), qint64(2));
+    QVariantList rows = loaded.last().at(1).toList();
+    QCOMPARE(rows.size(), 50);
+    QCOMPARE(rows.first().toList().first().toLongLong(), qint64(51));
+
+    // The count of a later refresh uses the new page size
+    source.refresh();
+    QTRY_COMPARE(bar.pageCount(), qint64(3));
+    QCOMPARE(bar.pageSize(), qint64(50));
+}
+
+QTEST_MAIN(TestSqlPageSource)
+
+#include "tst_sqlpagesource.moc"
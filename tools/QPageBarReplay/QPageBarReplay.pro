@@ -0,0 +1,29 @@
+QT       += core gui
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+# Replays a trace recorded with QPageBar::setTraceDevice without a display server:
+#   ./QPageBarReplay session.qpt
+# Use --realtime to keep the pauses of the recording, e.g. to reproduce coalescing
+
+SOURCES += \
+    main.cpp \
+    ../../src/english/qpagebar.cpp \
+    ../../src/english/qpagebarmodel.cpp \
+    ../../src/english/qpagekeyindex.cpp \
+    ../../src/english/qpagelatency.cpp \
+    ../../src/english/qpagenumbervalidator.cpp \
+    ../../src/english/qpagetrace.cpp
+
+HEADERS += \
+    ../../src/english/pagewindow.h \
+    ../../src/english/qpagebar.h \
+    ../../src/english/qpagebarmodel.h \
+    ../../src/english/qpagekeyindex.h \
+    ../../src/english/qpagelatency.h \
+    ../../src/english/qpagenumbervalidator.h \
+    ../../src/english/qpageprovider.h \
+    ../../src/english/qpagetrace.h
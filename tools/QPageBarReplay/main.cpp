@@ -0,0 +1,255 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QTextStream>
+#include <QTimer>
+#include <climits>
+
+#include "../../src/english/qpagebar.h"
+#include "../../src/english/qpagebarmodel.h"
+#include "../../src/english/qpagetrace.h"
+
+/**
+* @brief Replays a trace of QPageBar::setTraceDevice on a headless QPageBar through the same paths as the user:
+*        the </> buttons and the page buttons are clicked, and jumps are typed into the page number input box.
+*        The settings and counts of the trace are set through the same functions as recorded, pages adopted from a model are fed to a model of the replay.
+*        Reports the latency of each kind of event and the throughput of the whole replay
+*/
+class QPageBarReplay
+{
+public:
+    QPageBarReplay(QPageBar* pageBar, bool realtime) :
+        m_pageBar(pageBar),
+        m_realtime(realtime),
+        m_skipped(0),
+        m_busyNsecs(0),
+        m_wallNsecs(0)
+    {
+        m_lineEdit = m_pageBar->findChild<QLineEdit*>();
+        m_previousButton = findButton(QStringLiteral("<"));
+        m_nextButton = findButton(QStringLiteral(">"));
+        m_jumpButton = findButton(QStringLiteral("Ok"));
+
+        // In keyset mode the replay answers like a backend without latency, so the neighbours of each page can be opened
+        QObject::connect(m_pageBar, &QPageBar::keysetRequested, m_pageBar, [this](qint64 page) {
+            m_pageBar->setPageKeys(page, page, page);
+        });
+    }
+
+    /**
+    * @brief Replay all events of the stream
+    * @return false if the stream is not a trace
+    */
+    bool run(QDataStream& stream)
+    {
+        if (!QPageTrace::readHeader(stream))
+            return false;
+
+        QPageTrace::Event event = {};
+        QElapsedTimer clock;
+        clock.start();
+        while (QPageTrace::readEvent(stream, &event))
+        {
+            // 1. Wait for the time of the event, the timers of the page bar, e.g. coalescing, keep running meanwhile
+            if (m_realtime)
+                waitUntil(clock, event.usecs);
+
+            // 2. Find the widget before the timer starts, only the click itself is measured
+            QPushButton* button = nullptr;
+            switch (event.kind)
+            {
+            case QPageTrace::Previous: button = m_previousButton; break;
+            case QPageTrace::Next: button = m_nextButton; break;
+            case QPageTrace::Page: button = findPageButton(event.value); break;
+            case QPageTrace::Jump: button = event.value >= 1 && event.value <= m_pageBar->pageCount() ? m_jumpButton : nullptr; break;
+            default: break;
+            }
+            bool isClick = event.kind >= QPageTrace::Previous && event.kind <= QPageTrace::Jump;
+
+            // Buttons that are missing or disabled, e.g. after a count that is not part of the trace, would not react to the user either
+            if (isClick && (button == nullptr || !button->isEnabled()))
+            {
+                m_skipped++;
+                continue;
+            }
+            if (event.kind == QPageTrace::Jump)
+                m_lineEdit->setText(QString::number(event.value));
+
+            // 3. Perform the event
+            QElapsedTimer timer;
+            timer.start();
+            switch (event.kind)
+            {
+            case QPageTrace::Count: m_pageBar->setCount(event.value, event.showCount); break;
+            case QPageTrace::TotalCount: m_pageBar->setTotalCount(event.value); break;
+            case QPageTrace::EstimatedCount: m_pageBar->setEstimatedCount(event.value, event.showCount); break;
+            case QPageTrace::Estimate: m_pageBar->setEstimate(event.value); break;
+            case QPageTrace::RowCount: m_pageBar->setRowCount(event.value, event.showCount); break;
+            case QPageTrace::PageSize: m_pageBar->setPageSize(event.value); break;
+            case QPageTrace::Elided: m_pageBar->setElided(event.value != 0); break;
+            case QPageTrace::KeysetMode: m_pageBar->setKeysetMode(event.value != 0); break;
+            case QPageTrace::ModelState: applyModelState(event); break;
+            default: button->click(); break;
+            }
+            qint64 nsecs = timer.nsecsElapsed();
+
+            m_histograms[event.kind].add(nsecs);
+            m_busyNsecs += nsecs;
+
+            // 4. Deliver what the event has posted, e.g. layout requests, as the event loop would between two clicks
+            QCoreApplication::processEvents();
+        }
+        m_wallNsecs = clock.nsecsElapsed();
+        return stream.atEnd();
+    }
+
+    /**
+    * @brief Print one line per kind of event with the latencies in microseconds, then the throughput
+    */
+    void report(QTextStream& out) const
+    {
+        static const char* const names[] = { "", "Count", "TotalCount", "Previous", "Next", "Page", "Jump", "EstimatedCount",
+                                             "Estimate", "RowCount", "PageSize", "Elided", "KeysetMode", "ModelState" };
+
+        qint64 count = 0;
+        out << QStringLiteral("%1 %2 %3 %4 %5 %6\n").arg(QStringLiteral("event"), -16).arg(QStringLiteral("count"), 10)
+                   .arg(QStringLiteral("mean us"), 10).arg(QStringLiteral("p50 us"), 10).arg(QStringLiteral("p99 us"), 10)
+                   .arg(QStringLiteral("max us"), 10);
+        for (int kind = QPageTrace::Count; kind <= QPageTrace::ModelState; kind++)
+        {
+            const QPageLatencyHistogram& histogram = m_histograms[kind];
+            if (histogram.count() == 0)
+                continue;
+            count += histogram.count();
+
+            // The percentiles are the upper limits of the power-of-two buckets
+            out << QStringLiteral("%1 %2 %3 %4 %5 %6\n").arg(QLatin1String(names[kind]), -16).arg(histogram.count(), 10)
+                       .arg(double(histogram.totalNsecs()) / 1e3 / double(histogram.count()), 10, 'f', 1)
+                       .arg(QStringLiteral("<%1").arg(histogram.percentile(0.5)), 10)
+                       .arg(QStringLiteral("<%1").arg(histogram.percentile(0.99)), 10)
+                       .arg(double(histogram.maxNsecs()) / 1e3, 10, 'f', 1);
+        }
+
+        out << QStringLiteral("%1 events replayed, %2 skipped\n").arg(count).arg(m_skipped);
+        if (m_busyNsecs > 0)
+        {
+            out << QStringLiteral("%1 ms in the page bar, %2 events/s\n").arg(double(m_busyNsecs) / 1e6, 0, 'f', 3)
+                       .arg(double(count) * 1e9 / double(m_busyNsecs), 0, 'f', 0);
+        }
+        out << QStringLiteral("%1 ms wall time\n").arg(double(m_wallNsecs) / 1e6, 0, 'f', 3);
+    }
+
+private:
+    void applyModelState(const QPageTrace::Event& event)
+    {
+        // The model is only bound once the trace needs it, it costs a state update per navigation
+        if (m_pageBar->model() == nullptr)
+            m_pageBar->setModel(&m_model);
+        m_model.setState(event.window, event.value, nullptr);
+    }
+
+    QPushButton* findButton(const QString& text) const
+    {
+        for (QPushButton* button : m_pageBar->findChildren<QPushButton*>())
+        {
+            if (!button->isCheckable() && button->text() == text)
+                return button;
+        }
+        return nullptr;
+    }
+
+    QPushButton* findPageButton(qint64 page) const
+    {
+        // The page buttons are the only checkable buttons, hidden ones are kept for reuse
+        const QString text = QString::number(page);
+        for (QPushButton* button : m_pageBar->findChildren<QPushButton*>())
+        {
+            if (button->isCheckable() && !button->isHidden() && button->text() == text)
+                return button;
+        }
+        return nullptr;
+    }
+
+    static void waitUntil(const QElapsedTimer& clock, qint64 usecs)
+    {
+        qint64 msecs = usecs / 1000 - clock.elapsed();
+        if (msecs <= 0)
+            return;
+        QEventLoop loop;
+        QTimer::singleShot(int(qMin<qint64>(msecs, INT_MAX)), &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+
+    QPageBar* m_pageBar;
+    QLineEdit* m_lineEdit;
+    QPushButton* m_previousButton;
+    QPushButton* m_nextButton;
+    QPushButton* m_jumpButton;
+    bool m_realtime;
+
+    /**
+    * @brief The latencies of each kind of event, indexed by QPageTrace::Kind
+    */
+    QPageLatencyHistogram m_histograms[QPageTrace::ModelState + 1];
+
+    /**
+    * @brief Stands in for the model of the recorded bar
+    */
+    QPageBarModel m_model;
+
+    qint64 m_skipped;
+    qint64 m_busyNsecs;
+    qint64 m_wallNsecs;
+};
+
+int main(int argc, char* argv[])
+{
+    // Run without a display server unless another platform is chosen
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Replays a trace recorded with QPageBar::setTraceDevice and reports latency and throughput"));
+    parser.addHelpOption();
+    parser.addPositionalArgument(QStringLiteral("trace"), QStringLiteral("The trace file"));
+    QCommandLineOption realtimeOption(QStringLiteral("realtime"), QStringLiteral("Keep the pauses between the events of the recording"));
+    QCommandLineOption elidedOption(QStringLiteral("elided"), QStringLiteral("Use the elided layout, like QPageBar::setElided"));
+    QCommandLineOption coalescingOption(QStringLiteral("coalescing"), QStringLiteral("Coalesce pageChanged, like QPageBar::setCoalescing"),
+                                        QStringLiteral("ms"), QStringLiteral("0"));
+    parser.addOptions({ realtimeOption, elidedOption, coalescingOption });
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    if (parser.positionalArguments().size() != 1)
+        parser.showHelp(1);
+
+    QFile file(parser.positionalArguments().first());
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        err << QStringLiteral("Cannot open %1: %2\n").arg(file.fileName(), file.errorString());
+        return 1;
+    }
+
+    // The bar is configured like the recorded one, the trace itself starts with its first setCount
+    QPageBar pageBar;
+    pageBar.setElided(parser.isSet(elidedOption));
+    pageBar.setCoalescing(parser.value(coalescingOption).toInt());
+
+    QPageBarReplay replay(&pageBar, parser.isSet(realtimeOption));
+    QDataStream stream(&file);
+    bool complete = replay.run(stream);
+    replay.report(out);
+    out.flush();
+    if (!complete)
+    {
+        err << QStringLiteral("%1 is not a trace or is damaged\n").arg(file.fileName());
+        return 1;
+    }
+    return 0;
+}